@@ -0,0 +1,107 @@
+#include "core/graph.h"
+#include "core/graph_builder.h"
+#include "core/utils.h"
+#include <iostream>
+#include <string>
+
+// Converts a text edge list ("FromNodeId ToNodeId Weight" per line) into the
+// binary CSR format that the MST binaries can mmap directly.
+int main(int argc, char *argv[])
+{
+    cxxopts::Options options(
+        "convert_graph",
+        "Convert a text edge list into the binary CSR graph format");
+    options.add_options(
+        "",
+        {
+            {"nThreads", "Number of threads used to parse the input",
+             cxxopts::value<uintE>()->default_value(DEFAULT_NUMBER_OF_THREADS)},
+            {"inputFile", "Input text edge list path",
+             cxxopts::value<std::string>()},
+            {"outputFile", "Output binary graph path",
+             cxxopts::value<std::string>()},
+            {"vertexType", "Vertex id type: auto, uint32 or uint64",
+             cxxopts::value<std::string>()->default_value("auto")},
+            {"weightType", "Weight type: auto, int16, int32, float or double",
+             cxxopts::value<std::string>()->default_value("auto")},
+            {"verify", "Re-open the output and verify its checksum",
+             cxxopts::value<bool>()->default_value("false")},
+        });
+
+    auto cl_options = options.parse(argc, argv);
+    if (!cl_options.count("inputFile") || !cl_options.count("outputFile")) {
+        std::cerr << "Usage: ./convert_graph --inputFile graph.txt --outputFile graph.bin" << std::endl;
+        return 1;
+    }
+    uintE n_threads = cl_options["nThreads"].as<uintE>();
+    std::string input_file_path = cl_options["inputFile"].as<std::string>();
+    std::string output_file_path = cl_options["outputFile"].as<std::string>();
+
+    std::cout << std::fixed;
+    std::cout << "Input File Path: " << input_file_path << std::endl;
+    std::cout << "Output File Path: " << output_file_path << std::endl;
+
+    timer t1;
+    t1.start();
+    TextEdgeList edges(input_file_path, n_threads);
+    EdgeListSummary summary = edges.summarize();
+    double scan_time = t1.next();
+
+    // Narrowest fitting types unless overridden on the command line
+    GraphTypeInfo info = summary.types();
+    std::string vertex_type = cl_options["vertexType"].as<std::string>();
+    std::string weight_type = cl_options["weightType"].as<std::string>();
+    if (vertex_type != "auto") {
+        if (vertex_type != "uint32" && vertex_type != "uint64") {
+            std::cerr << "Unknown vertex type: " << vertex_type << std::endl;
+            return 1;
+        }
+        info.wideVertices = vertex_type == "uint64";
+        if (!vertexTypeHolds(info.wideVertices, summary.maxVertexId)) {
+            std::cerr << "Vertex type " << vertex_type << " cannot hold vertex id " << summary.maxVertexId << std::endl;
+            return 1;
+        }
+    }
+    if (weight_type != "auto") {
+        try {
+            info.weight = weightKindFromName(weight_type);
+        } catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        if (!weightKindHolds(info.weight, summary.minWeight, summary.maxWeight, summary.realWeights)) {
+            std::cerr << "Weight type " << weight_type << " cannot hold the input weights ("
+                      << (summary.realWeights ? "fractional, " : "") << "from " << summary.minWeight << " to "
+                      << summary.maxWeight << ")" << std::endl;
+            return 1;
+        }
+    }
+
+    bool verify = cl_options["verify"].as<bool>();
+    dispatchGraphTypes(info, [&](auto vertexTag, auto weightTag) {
+        typedef typename decltype(vertexTag)::type V;
+        typedef typename decltype(weightTag)::type W;
+        CanonicalizeStats stats;
+        Graph<V, W> g = buildGraphFromText<V, W>(edges, summary.maxVertexId + 1, n_threads, &stats);
+        double build_time = t1.next();
+        g.writeGraphToBinary(output_file_path);
+        double write_time = t1.next();
+
+        printGraphTypes(g);
+        std::cout << "Vertices: " << g.numVertices() << std::endl;
+        std::cout << "Adjacency entries: " << g.numEdges() << std::endl;
+        std::cout << "Self-loops removed: " << stats.selfLoops << std::endl;
+        std::cout << "Duplicate edges removed: " << stats.duplicates << std::endl;
+        std::cout << "Text scan time: " << scan_time << std::endl;
+        std::cout << "Build time: " << build_time << std::endl;
+        std::cout << "Binary write time: " << write_time << std::endl;
+
+        if (verify) {
+            Graph<V, W> check;
+            check.readGraphFromBinary(output_file_path, true);
+            std::cout << "Checksum verified" << std::endl;
+        }
+    });
+
+    return 0;
+}
@@ -1,3 +1,5 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
 #include <vector>
 #include <thread>
 #include <queue>
@@ -6,6 +8,7 @@
 #include <condition_variable>
 #include <future>
 #include <atomic>
+#include <stdexcept>
 
 class ThreadPool {
 public:
@@ -25,7 +28,7 @@ private:
     bool stop;
 };
 
-ThreadPool::ThreadPool(size_t threads) : stop(false) {
+inline ThreadPool::ThreadPool(size_t threads) : stop(false) {
     for (size_t i = 0; i < threads; ++i)
         workers.emplace_back([this] {
             for (;;) {
@@ -43,7 +46,7 @@ ThreadPool::ThreadPool(size_t threads) : stop(false) {
         });
 }
 
-ThreadPool::~ThreadPool() {
+inline ThreadPool::~ThreadPool() {
     {
         std::unique_lock<std::mutex> lock(queue_mutex);
         stop = true;
@@ -72,3 +75,19 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
     condition.notify_one();
     return res;
 }
+
+// Splits [0, n) into nTasks contiguous blocks, runs f(begin, end, task) for
+// each block on the pool and waits for all of them
+template<class F>
+void poolFor(ThreadPool &pool, size_t nTasks, size_t n, F &&f) {
+    if (nTasks < 1)
+        nTasks = 1;
+    std::vector<std::future<void>> done;
+    done.reserve(nTasks);
+    for (size_t t = 0; t < nTasks; ++t)
+        done.push_back(pool.enqueue([&f, t, nTasks, n] { f(n * t / nTasks, n * (t + 1) / nTasks, t); }));
+    for (std::future<void> &d : done)
+        d.get();
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef BORUVKA_H
+#define BORUVKA_H
+#include "ThreadPool.h"
+#include "edge_list.h"
+#include "memory_policy.h"
+#include "union_find.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// Shared-memory parallel Boruvka over an undirected edge list. Every round
+// runs these phases, each split into nTasks blocks on the ThreadPool:
+//
+//   1. min-edge selection: every live edge offers itself to the components
+//      of both endpoints; each component keeps the lightest offer in an
+//      atomic slot (compare-and-swap on the edge position, ties broken by
+//      position so all components agree on one total order)
+//   2. hooking: every component unites the endpoints of its lightest edge in
+//      a ConcurrentDisjointSets (CAS linking); the chosen edges form a
+//      forest, and when two components pick each other only one of the two
+//      unites succeeds, so each forest edge is recorded once
+//   3. pointer jumping: every component finds its new root, halving paths
+//      with CAS as it goes
+//   4. contraction: edges are relabelled with their endpoints' roots and
+//      edges inside a component are filtered out; components without edges
+//      are retired
+//
+// Components are named by a vertex id, so all per-component arrays are
+// indexed by vertex and only the live components are visited. Returns the
+// positions (in edges) of the minimum spanning forest edges.
+template <class V, class W>
+std::vector<uint64_t> boruvkaMSF(const PolicyVector<WeightedEdge<V, W>> &edges, V numVertices,
+                                 ThreadPool &pool, size_t nTasks)
+{
+#pragma pack(push, 1)
+  struct LiveEdge
+  {
+    V u;
+    V v;
+    W weight;
+    uint64_t id; // position in edges
+  };
+#pragma pack(pop)
+  const uint64_t NONE = std::numeric_limits<uint64_t>::max();
+  if (nTasks < 1)
+    nTasks = 1;
+
+  // Parallel compaction: keep(i) decides, emit(i, out) writes the survivor
+  auto filter = [&](size_t n, auto keep, auto emit) {
+    std::vector<size_t> start(nTasks + 1, 0);
+    poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t t) {
+      size_t count = 0;
+      for (size_t i = begin; i < end; ++i)
+        count += keep(i);
+      start[t + 1] = count;
+    });
+    for (size_t t = 0; t < nTasks; ++t)
+      start[t + 1] += start[t];
+    poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t t) {
+      size_t out = start[t];
+      for (size_t i = begin; i < end; ++i)
+        if (keep(i))
+          emit(i, out++);
+    });
+    return start[nTasks];
+  };
+
+  PolicyVector<LiveEdge> live(edges.size()), next;
+  poolFor(pool, nTasks, edges.size(), [&](size_t begin, size_t end, size_t) {
+    for (size_t i = begin; i < end; ++i)
+      live[i] = LiveEdge{edges[i].src, edges[i].dest, edges[i].weight, i};
+  });
+
+  std::unique_ptr<std::atomic<uint64_t>[]> best(new std::atomic<uint64_t>[numVertices]);
+  ConcurrentDisjointSets<V> sets(numVertices);
+  PolicyVector<V> parent(numVertices);
+  std::vector<V> active(numVertices), nextActive;
+  for (V v = 0; v < numVertices; ++v)
+    active[v] = v;
+  std::vector<std::vector<uint64_t>> chosen(nTasks);
+
+  auto lighter = [&](uint64_t a, uint64_t b) {
+    return live[a].weight < live[b].weight || (live[a].weight == live[b].weight && a < b);
+  };
+  auto offer = [&](V c, uint64_t e) {
+    uint64_t cur = best[c].load(std::memory_order_relaxed);
+    while ((cur == NONE || lighter(e, cur)) &&
+           !best[c].compare_exchange_weak(cur, e, std::memory_order_relaxed))
+    {
+    }
+  };
+
+  while (!live.empty())
+  {
+    poolFor(pool, nTasks, active.size(), [&](size_t begin, size_t end, size_t) {
+      for (size_t i = begin; i < end; ++i)
+        best[active[i]].store(NONE, std::memory_order_relaxed);
+    });
+
+    // 1. Lightest edge per component
+    poolFor(pool, nTasks, live.size(), [&](size_t begin, size_t end, size_t) {
+      for (size_t e = begin; e < end; ++e)
+      {
+        offer(live[e].u, e);
+        offer(live[e].v, e);
+      }
+    });
+
+    // 2. Hook along the lightest edges
+    poolFor(pool, nTasks, active.size(), [&](size_t begin, size_t end, size_t t) {
+      for (size_t i = begin; i < end; ++i)
+      {
+        uint64_t e = best[active[i]].load(std::memory_order_relaxed);
+        if (e != NONE && sets.unite(live[e].u, live[e].v))
+          chosen[t].push_back(live[e].id);
+      }
+    });
+
+    // 3. Every component points at its root
+    poolFor(pool, nTasks, active.size(), [&](size_t begin, size_t end, size_t) {
+      for (size_t i = begin; i < end; ++i)
+        parent[active[i]] = sets.find(active[i]);
+    });
+
+    // 4. Contract: relabel edges by root, drop edges inside a component and
+    // retire components that are finished
+    next.resize(live.size());
+    size_t kept = filter(
+        live.size(),
+        [&](size_t e) { return parent[live[e].u] != parent[live[e].v]; },
+        [&](size_t e, size_t out) {
+          next[out] = LiveEdge{parent[live[e].u], parent[live[e].v], live[e].weight, live[e].id};
+        });
+    next.resize(kept);
+    live.swap(next);
+
+    nextActive.resize(active.size());
+    size_t roots = filter(
+        active.size(),
+        [&](size_t i) {
+          V c = active[i];
+          return parent[c] == c && best[c].load(std::memory_order_relaxed) != NONE;
+        },
+        [&](size_t i, size_t out) { nextActive[out] = active[i]; });
+    nextActive.resize(roots);
+    active.swap(nextActive);
+  }
+
+  std::vector<uint64_t> forest;
+  for (const std::vector<uint64_t> &c : chosen)
+    forest.insert(forest.end(), c.begin(), c.end());
+  return forest;
+}
+
+#endif
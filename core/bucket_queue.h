@@ -0,0 +1,128 @@
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+#include "memory_policy.h"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Indexed bucket queue over items 0 .. capacity-1 with small integer keys
+// 0 .. numBuckets-1. Each bucket is an intrusive doubly linked
+// list threaded through per-item next/prev arrays, so push, decrease-key and
+// removal are O(1). Prim extracts keys in no particular order (a new
+// frontier edge can be lighter than the last one popped), so instead of a
+// moving cursor the lowest non-empty bucket is found with a two-level bitmap:
+// one bit per bucket, and one summary bit per 64-bucket word. That caps the
+// key range at BUCKET_QUEUE_MAX_KEYS.
+static const uint32_t BUCKET_QUEUE_MAX_KEYS = 64 * 64;
+
+template <class Item>
+class BucketQueue
+{
+public:
+  typedef std::pair<uint32_t, Item> Entry; // (bucket, item)
+
+private:
+  static constexpr Item NONE = std::numeric_limits<Item>::max();
+  static constexpr uint32_t NO_BUCKET = std::numeric_limits<uint32_t>::max();
+
+  std::vector<Item> head_;
+  PolicyVector<Item> next_;
+  PolicyVector<Item> prev_;
+  PolicyVector<uint32_t> bucket_;
+  uint64_t words_[BUCKET_QUEUE_MAX_KEYS / 64] = {0};
+  uint64_t summary_ = 0;
+  size_t size_ = 0;
+
+  void link(Item item, uint32_t b)
+  {
+    Item first = head_[b];
+    next_[item] = first;
+    prev_[item] = NONE;
+    if (first != NONE)
+      prev_[first] = item;
+    head_[b] = item;
+    bucket_[item] = b;
+    words_[b / 64] |= 1ULL << (b % 64);
+    summary_ |= 1ULL << (b / 64);
+  }
+
+  void unlink(Item item)
+  {
+    uint32_t b = bucket_[item];
+    if (prev_[item] != NONE)
+      next_[prev_[item]] = next_[item];
+    else
+      head_[b] = next_[item];
+    if (next_[item] != NONE)
+      prev_[next_[item]] = prev_[item];
+    bucket_[item] = NO_BUCKET;
+    if (head_[b] == NONE)
+    {
+      words_[b / 64] &= ~(1ULL << (b % 64));
+      if (words_[b / 64] == 0)
+        summary_ &= ~(1ULL << (b / 64));
+    }
+  }
+
+public:
+  BucketQueue(Item capacity, uint32_t numBuckets)
+      : head_(numBuckets, NONE), next_(capacity), prev_(capacity), bucket_(capacity, NO_BUCKET)
+  {
+    if (numBuckets > BUCKET_QUEUE_MAX_KEYS)
+      throw std::invalid_argument("Bucket queue key range too large");
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  bool contains(Item item) const { return bucket_[item] != NO_BUCKET; }
+  uint32_t bucketOf(Item item) const { return bucket_[item]; }
+
+  void push(Item item, uint32_t b)
+  {
+    link(item, b);
+    size_++;
+  }
+
+  void decreaseKey(Item item, uint32_t b)
+  {
+    unlink(item);
+    link(item, b);
+  }
+
+  // Inserts item, or moves it to a lower bucket. Returns true if the queue
+  // changed.
+  bool pushOrDecrease(Item item, uint32_t b)
+  {
+    if (!contains(item))
+    {
+      push(item, b);
+      return true;
+    }
+    if (b < bucket_[item])
+    {
+      decreaseKey(item, b);
+      return true;
+    }
+    return false;
+  }
+
+  // Removes an item from the lowest non-empty bucket
+  Entry pop()
+  {
+    uint32_t w = __builtin_ctzll(summary_);
+    uint32_t b = w * 64 + __builtin_ctzll(words_[w]);
+    Item item = head_[b];
+    unlink(item);
+    size_--;
+    return Entry(b, item);
+  }
+};
+
+template <class Item>
+constexpr Item BucketQueue<Item>::NONE;
+template <class Item>
+constexpr uint32_t BucketQueue<Item>::NO_BUCKET;
+
+#endif
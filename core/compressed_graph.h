@@ -0,0 +1,243 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+#include "graph.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Read-only compressed adjacency, built from a CSR Graph. Each vertex u owns
+// one byte-aligned row:
+//
+//   varint degree
+//   d weights bit-packed at weightBits_ bits each, padded to a byte
+//   varint zigzag(v_0 - u), varint (v_1 - v_0), ..., varint (v_{d-1} - v_{d-2})
+//
+// Neighbour lists are sorted so the deltas are small (especially after
+// --reorder), integral weights are stored as (w - minWeight_) in just enough
+// bits for the per-graph range (10 bits for the generator's 1..999), and
+// floating-point weights are stored verbatim. Row starts are kept as a
+// 64-bit base per block of ROW_BLOCK vertices plus a 32-bit offset per
+// vertex. Rows are decoded on the fly by forEachNeighbor(), so the Prim
+// engines can run on it in place of Graph.
+template <class V, class W>
+class CompressedGraph
+{
+public:
+  typedef V VertexType;
+  typedef W WeightType;
+
+private:
+  static const uint64_t ROW_BLOCK = 64;
+  static const size_t READ_PADDING = 8; // allows unaligned 8-byte reads at the tail
+
+  V numVertices_ = 0;
+  uint64_t numEdges_ = 0;
+  PolicyVector<uint64_t> blockBase_;
+  PolicyVector<uint32_t> rowOffset_;
+  PolicyVector<uint8_t> bytes_;
+  W minWeight_ = 0;
+  unsigned weightBits_ = 0;
+
+  static void putVarint(PolicyVector<uint8_t> &out, uint64_t x)
+  {
+    while (x >= 0x80)
+    {
+      out.push_back(uint8_t(x) | 0x80);
+      x >>= 7;
+    }
+    out.push_back(uint8_t(x));
+  }
+
+  static uint64_t getVarint(const uint8_t *&p)
+  {
+    uint64_t x = 0;
+    unsigned shift = 0;
+    while (*p & 0x80)
+    {
+      x |= uint64_t(*p++ & 0x7f) << shift;
+      shift += 7;
+    }
+    x |= uint64_t(*p++) << shift;
+    return x;
+  }
+
+  static uint64_t zigzag(int64_t x) { return (uint64_t(x) << 1) ^ uint64_t(x >> 63); }
+  static int64_t unzigzag(uint64_t x) { return int64_t(x >> 1) ^ -int64_t(x & 1); }
+
+  const uint8_t *row(V u) const
+  {
+    return bytes_.data() + blockBase_[u / ROW_BLOCK] + rowOffset_[u];
+  }
+
+  uint64_t encodeWeight(W w) const
+  {
+    uint64_t bits = 0;
+    if (std::is_floating_point<W>::value)
+      std::memcpy(&bits, &w, sizeof(W));
+    else
+      bits = uint64_t(int64_t(w) - int64_t(minWeight_));
+    return bits;
+  }
+
+  W decodeWeight(const uint8_t *weights, uint64_t i) const
+  {
+    if (std::is_floating_point<W>::value)
+    {
+      W w;
+      std::memcpy(&w, weights + i * sizeof(W), sizeof(W));
+      return w;
+    }
+    uint64_t bitPos = i * weightBits_;
+    uint64_t word;
+    std::memcpy(&word, weights + bitPos / 8, sizeof(word));
+    uint64_t mask = weightBits_ == 64 ? ~0ULL : ((1ULL << weightBits_) - 1);
+    return W(int64_t((word >> (bitPos % 8)) & mask) + int64_t(minWeight_));
+  }
+
+public:
+  CompressedGraph() = default;
+
+  explicit CompressedGraph(const Graph<V, W> &g)
+  {
+    numVertices_ = g.numVertices();
+    numEdges_ = g.numEdges();
+
+    // Weight range decides the packed width
+    W lo = 0, hi = 0;
+    bool first = true;
+    for (V u = 0; u < numVertices_; ++u)
+      for (const auto &nbr : g.getNeighbors(u))
+      {
+        W w = nbr.weight;
+        if (first || w < lo) lo = w;
+        if (first || w > hi) hi = w;
+        first = false;
+      }
+    minWeight_ = lo;
+    if (std::is_floating_point<W>::value)
+      weightBits_ = 8 * sizeof(W);
+    else
+    {
+      uint64_t range = uint64_t(int64_t(hi) - int64_t(lo));
+      weightBits_ = 0;
+      while (weightBits_ < 64 && (range >> weightBits_) != 0)
+        ++weightBits_;
+    }
+
+    blockBase_.resize((uint64_t(numVertices_) + ROW_BLOCK - 1) / ROW_BLOCK);
+    rowOffset_.resize(numVertices_);
+    std::vector<std::pair<V, W>> sorted;
+    for (V u = 0; u < numVertices_; ++u)
+    {
+      if (u % ROW_BLOCK == 0)
+        blockBase_[u / ROW_BLOCK] = bytes_.size();
+      uint64_t offset = bytes_.size() - blockBase_[u / ROW_BLOCK];
+      if (offset > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("Compressed row block exceeds 4 GB");
+      rowOffset_[u] = (uint32_t)offset;
+
+      sorted.clear();
+      for (const auto &nbr : g.getNeighbors(u))
+        sorted.emplace_back(nbr.vertex, nbr.weight);
+      std::sort(sorted.begin(), sorted.end(),
+                [](const std::pair<V, W> &a, const std::pair<V, W> &b) { return a.first < b.first; });
+
+      putVarint(bytes_, sorted.size());
+
+      // Bit-pack the weights, least significant bit first
+      uint64_t weightBytes = (sorted.size() * weightBits_ + 7) / 8;
+      size_t base = bytes_.size();
+      bytes_.resize(base + weightBytes, 0);
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        uint64_t bits = encodeWeight(sorted[i].second);
+        uint64_t bitPos = i * weightBits_;
+        for (unsigned b = 0; b < weightBits_; ++b, ++bitPos)
+          if ((bits >> b) & 1)
+            bytes_[base + bitPos / 8] |= uint8_t(1u << (bitPos % 8));
+      }
+
+      V prev = u;
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        if (i == 0)
+          putVarint(bytes_, zigzag(int64_t(sorted[i].first) - int64_t(u)));
+        else
+          putVarint(bytes_, uint64_t(sorted[i].first - prev));
+        prev = sorted[i].first;
+      }
+    }
+    bytes_.resize(bytes_.size() + READ_PADDING, 0);
+    bytes_.shrink_to_fit();
+  }
+
+  V numVertices() const { return numVertices_; }
+  uint64_t numEdges() const { return numEdges_; }
+  unsigned weightBits() const { return weightBits_; }
+
+  size_t sizeInBytes() const
+  {
+    return bytes_.size() + blockBase_.size() * sizeof(uint64_t) + rowOffset_.size() * sizeof(uint32_t);
+  }
+
+  V degree(V u) const
+  {
+    const uint8_t *p = row(u);
+    return (V)getVarint(p);
+  }
+
+  // Decodes u's row and calls f(neighbor, weight) for every incident edge
+  template <class F>
+  void forEachNeighbor(V u, F &&f) const
+  {
+    const uint8_t *p = row(u);
+    uint64_t deg = getVarint(p);
+    const uint8_t *weights = p;
+    p += (deg * weightBits_ + 7) / 8;
+    V v = u;
+    for (uint64_t i = 0; i < deg; ++i)
+    {
+      if (i == 0)
+        v = V(int64_t(u) + unzigzag(getVarint(p)));
+      else
+        v = V(v + getVarint(p));
+      f(v, decodeWeight(weights, i));
+    }
+  }
+};
+
+// Size of the plain CSR arrays, for reporting the compression ratio
+template <class V, class W>
+size_t csrSizeInBytes(const Graph<V, W> &g)
+{
+  return (uint64_t(g.numVertices()) + 1) * sizeof(uint64_t) +
+         g.numEdges() * sizeof(typename Graph<V, W>::Neighbor);
+}
+
+// Calls f(graph) with either the CSR graph itself or, when compress is set,
+// a CompressedGraph built from it (the CSR arrays are released first).
+template <class V, class W, class F>
+void withGraphBackend(Graph<V, W> &g, bool compress, F &&f)
+{
+  if (!compress)
+  {
+    f(g);
+    return;
+  }
+  timer t1;
+  t1.start();
+  size_t before = csrSizeInBytes(g);
+  CompressedGraph<V, W> compressed(g);
+  g = Graph<V, W>();
+  std::cout << "Compressed graph : " << before << " -> " << compressed.sizeInBytes()
+            << " bytes (" << compressed.weightBits() << "-bit weights), time taken: "
+            << t1.stop() << std::endl;
+  f(compressed);
+}
+
+#endif
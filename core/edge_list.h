@@ -0,0 +1,56 @@
+#ifndef EDGE_LIST_H
+#define EDGE_LIST_H
+#include "memory_policy.h"
+#include "utils.h"
+#include <cstdint>
+#include <vector>
+
+// Undirected weighted edge for the edge-centric MST engines (Boruvka,
+// Kruskal variants), packed like the CSR adjacency entries
+#pragma pack(push, 1)
+template <class V, class W>
+struct WeightedEdge
+{
+  V src;
+  V dest;
+  W weight;
+};
+#pragma pack(pop)
+
+// Lists every undirected edge of g once, as (u, v, w) with u < v, in vertex
+// order. Rows are scanned by nThreads threads: each counts its block, a
+// prefix sum places the blocks, and a second scan fills them. GraphT is Graph
+// or CompressedGraph.
+template <class GraphT>
+PolicyVector<WeightedEdge<typename GraphT::VertexType, typename GraphT::WeightType>>
+collectEdges(const GraphT &g, uintE nThreads)
+{
+  typedef typename GraphT::VertexType V;
+  typedef typename GraphT::WeightType W;
+  uint64_t n = g.numVertices();
+  if (nThreads < 1)
+    nThreads = 1;
+
+  std::vector<uint64_t> start(nThreads + 1, 0);
+  runOnThreads(nThreads, [&](uintE t) {
+    uint64_t count = 0;
+    for (uint64_t u = n * t / nThreads; u < n * (t + 1) / nThreads; ++u)
+      g.forEachNeighbor((V)u, [&](V v, W) { count += u < v; });
+    start[t + 1] = count;
+  });
+  for (uintE t = 0; t < nThreads; ++t)
+    start[t + 1] += start[t];
+
+  PolicyVector<WeightedEdge<V, W>> edges(start[nThreads]);
+  runOnThreads(nThreads, [&](uintE t) {
+    uint64_t out = start[t];
+    for (uint64_t u = n * t / nThreads; u < n * (t + 1) / nThreads; ++u)
+      g.forEachNeighbor((V)u, [&](V v, W w) {
+        if (u < v)
+          edges[out++] = WeightedEdge<V, W>{(V)u, v, w};
+      });
+  });
+  return edges;
+}
+
+#endif
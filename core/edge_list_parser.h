@@ -0,0 +1,234 @@
+#ifndef EDGE_LIST_PARSER_H
+#define EDGE_LIST_PARSER_H
+#include "graph_binary.h"
+#include "graph_types.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Id and weight ranges of an edge list, used to pick the Graph instantiation
+struct EdgeListSummary
+{
+  uint64_t numEdges = 0;
+  uint64_t maxVertexId = 0;
+  double minWeight = std::numeric_limits<double>::max();
+  double maxWeight = std::numeric_limits<double>::lowest();
+  bool realWeights = false;
+
+  void add(uint64_t src, uint64_t dest, double weight)
+  {
+    numEdges++;
+    maxVertexId = std::max({maxVertexId, src, dest});
+    minWeight = std::min(minWeight, weight);
+    maxWeight = std::max(maxWeight, weight);
+  }
+
+  void merge(const EdgeListSummary &other)
+  {
+    numEdges += other.numEdges;
+    maxVertexId = std::max(maxVertexId, other.maxVertexId);
+    minWeight = std::min(minWeight, other.minWeight);
+    maxWeight = std::max(maxWeight, other.maxWeight);
+    realWeights = realWeights || other.realWeights;
+  }
+
+  GraphTypeInfo types() const
+  {
+    return chooseGraphTypes(maxVertexId, numEdges == 0 ? 0 : minWeight,
+                            numEdges == 0 ? 0 : maxWeight, realWeights);
+  }
+};
+
+// Skips spaces, tabs and carriage returns (but not newlines)
+inline const char *skipBlanks(const char *p, const char *end)
+{
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    ++p;
+  return p;
+}
+
+inline const char *skipLine(const char *p, const char *end)
+{
+  while (p < end && *p != '\n')
+    ++p;
+  return p < end ? p + 1 : end;
+}
+
+// Hand-rolled decimal scanner; replaces istringstream in the hot path.
+// Returns false without consuming a token if p does not start a number.
+inline bool scanInteger(const char *&p, const char *end, long long &value)
+{
+  p = skipBlanks(p, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p >= end || *p < '0' || *p > '9')
+    return false;
+  long long v = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+    v = v * 10 + (*p++ - '0');
+  value = negative ? -v : v;
+  return true;
+}
+
+// Scans an integer or real weight. Integers take the fast path above; a
+// fractional part or exponent falls back to strtod on the token.
+inline bool scanWeight(const char *&p, const char *end, double &value, bool &real)
+{
+  p = skipBlanks(p, end);
+  const char *token = p;
+  long long integer;
+  if (!scanInteger(p, end, integer) && (p >= end || *p != '.'))
+    return false;
+  if (p < end && (*p == '.' || *p == 'e' || *p == 'E'))
+  {
+    char buffer[64];
+    size_t len = 0;
+    while (token + len < end && len + 1 < sizeof(buffer) && token[len] != '\n' &&
+           token[len] != ' ' && token[len] != '\t' && token[len] != '\r')
+      ++len;
+    std::memcpy(buffer, token, len);
+    buffer[len] = '\0';
+    char *parsed;
+    value = std::strtod(buffer, &parsed);
+    if (parsed == buffer)
+      return false;
+    p = token + (parsed - buffer);
+    real = true;
+    return true;
+  }
+  value = (double)integer;
+  return true;
+}
+
+// Parses "src dest weight" lines in [begin, end) and calls f(src, dest,
+// weight) for each. Comment lines starting with '#', blank lines and
+// malformed lines are skipped; real is set if any weight is not an integer.
+template <class F>
+void parseEdgeRange(const char *begin, const char *end, bool &real, F &&f)
+{
+  const char *p = begin;
+  while (p < end)
+  {
+    const char *line = skipBlanks(p, end);
+    if (line >= end)
+      break;
+    if (*line == '#' || *line == '\n')
+    {
+      p = skipLine(line, end);
+      continue;
+    }
+    long long src, dest;
+    double weight;
+    p = line;
+    if (scanInteger(p, end, src) && scanInteger(p, end, dest) &&
+        scanWeight(p, end, weight, real) && src >= 0 && dest >= 0)
+    {
+      f((uint64_t)src, (uint64_t)dest, weight);
+    }
+    p = skipLine(p, end);
+  }
+}
+
+// Text edge list mapped into memory and split into byte ranges whose
+// boundaries are moved forward to the next newline. Every pass parses the
+// ranges in parallel straight from the mapping, so no edge buffer is ever
+// materialized: the loader makes one pass for the id/weight ranges, then
+// GraphBuilder replays the file to count degrees and again to fill rows.
+class TextEdgeList
+{
+private:
+  MappedFile file_;
+  std::vector<size_t> bounds_;
+
+  // First line start at or after offset
+  size_t lineStart(size_t offset) const
+  {
+    const char *data = file_.data();
+    while (offset > 0 && offset < file_.size() && data[offset - 1] != '\n')
+      ++offset;
+    return std::min(offset, file_.size());
+  }
+
+  void split(size_t begin, size_t end, uintE nThreads)
+  {
+    size_t size = end - begin;
+    if (nThreads < 1)
+      nThreads = 1;
+    // Keep chunks large enough that thread start-up does not dominate
+    nThreads = (uintE)std::max<size_t>(1, std::min<size_t>(nThreads, size / (1 << 16) + 1));
+
+    bounds_.assign(nThreads + 1, end);
+    bounds_[0] = begin;
+    for (uintE i = 1; i < nThreads; ++i)
+      bounds_[i] = std::min(end, std::max(lineStart(begin + size / nThreads * i), bounds_[i - 1]));
+  }
+
+public:
+  TextEdgeList(const std::string &inputFilePath, uintE nThreads) : file_(inputFilePath)
+  {
+    split(0, file_.size(), nThreads);
+  }
+
+  // Only the part-th of parts line-aligned byte ranges of the file, e.g. one
+  // MPI rank's share. The parts are disjoint and cover every line once, and
+  // apart from the boundary lines only this part's pages are ever read.
+  TextEdgeList(const std::string &inputFilePath, uintE nThreads, uint64_t part, uint64_t parts)
+      : file_(inputFilePath)
+  {
+    size_t size = file_.size();
+    split(lineStart(size / parts * part), part + 1 == parts ? size : lineStart(size / parts * (part + 1)),
+          nThreads);
+  }
+
+  uintE numChunks() const
+  {
+    return (uintE)(bounds_.size() - 1);
+  }
+
+  // Calls f(src, dest, weight) for every edge; chunks are parsed
+  // concurrently, so f must be safe to call from several threads
+  template <class F>
+  void forEachEdge(F &&f) const
+  {
+    runOnThreads(numChunks(), [&](uintE i) {
+      bool real = false;
+      parseEdgeRange(file_.data() + bounds_[i], file_.data() + bounds_[i + 1], real, f);
+    });
+  }
+
+  // Like forEachEdge, but calls f(chunk, src, dest, weight) so callers can
+  // collect into one buffer per chunk without locking
+  template <class F>
+  void forEachChunkEdge(F &&f) const
+  {
+    runOnThreads(numChunks(), [&](uintE i) {
+      bool real = false;
+      parseEdgeRange(file_.data() + bounds_[i], file_.data() + bounds_[i + 1], real,
+                     [&](uint64_t src, uint64_t dest, double weight) { f(i, src, dest, weight); });
+    });
+  }
+
+  EdgeListSummary summarize() const
+  {
+    std::vector<EdgeListSummary> partial(numChunks());
+    runOnThreads(numChunks(), [&](uintE i) {
+      EdgeListSummary &s = partial[i];
+      parseEdgeRange(file_.data() + bounds_[i], file_.data() + bounds_[i + 1], s.realWeights,
+                     [&](uint64_t src, uint64_t dest, double weight) { s.add(src, dest, weight); });
+    });
+    EdgeListSummary summary;
+    for (const EdgeListSummary &s : partial)
+      summary.merge(s);
+    return summary;
+  }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef FILTER_KRUSKAL_H
+#define FILTER_KRUSKAL_H
+#include "ThreadPool.h"
+#include "edge_list.h"
+#include "memory_policy.h"
+#include "quick_sort.h"
+#include "union_find.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Filter-Kruskal (Osipov, Sanders, Singler): instead of sorting all edges,
+//
+//   run(E): if E is small, sort it and run plain Kruskal
+//           otherwise partition E around a pivot weight into E<= and E>,
+//           run(E<=), drop the edges of E> whose endpoints are now connected,
+//           run(what is left of E>)
+//
+// On sparse graphs most heavy edges close a cycle once the light ones are in
+// the forest, so they are filtered out without ever being sorted. Partition
+// and filter passes over large ranges are split into nTasks blocks on the
+// ThreadPool (count per block, prefix sum, scatter into a scratch buffer,
+// copy back). The filter threads run finds on a ConcurrentDisjointSets, so
+// they halve paths as they go. The edge array is reordered in place.
+template <class V, class W>
+class FilterKruskal
+{
+public:
+  typedef WeightedEdge<V, W> Edge;
+
+private:
+  static const size_t BASE_CASE = 1 << 12;     // sort and scan below this size
+  static const size_t PARALLEL_MIN = 1 << 16;  // sequential passes below this size
+  static const size_t PIVOT_SAMPLE = 31;
+
+  ThreadPool &pool_;
+  size_t nTasks_;
+  ConcurrentDisjointSets<V> sets_;
+  uint64_t treeEdges_;  // numVertices - 1: the forest cannot grow further
+  PolicyVector<Edge> scratch_;
+  std::vector<Edge> forest_;
+  std::mt19937_64 rng_;
+  uint64_t sortedEdges_ = 0;
+  uint64_t filteredEdges_ = 0;
+
+  bool complete() const
+  {
+    return forest_.size() >= treeEdges_;
+  }
+
+  void take(const Edge &e)
+  {
+    if (sets_.unite(e.src, e.dest))
+      forest_.push_back(e);
+  }
+
+  void kruskal(Edge *first, size_t n)
+  {
+    sampleSort(first, n, [](const Edge &a, const Edge &b) { return a.weight < b.weight; }, pool_, nTasks_);
+    sortedEdges_ += n;
+    for (size_t i = 0; i < n && !complete(); ++i)
+      take(first[i]);
+  }
+
+  W pickPivot(const Edge *first, size_t n)
+  {
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    W sample[PIVOT_SAMPLE];
+    for (size_t i = 0; i < PIVOT_SAMPLE; ++i)
+      sample[i] = first[pick(rng_)].weight;
+    std::nth_element(sample, sample + PIVOT_SAMPLE / 2, sample + PIVOT_SAMPLE);
+    return sample[PIVOT_SAMPLE / 2];
+  }
+
+  // Stable split of [first, first + n) into edges with keep(e) followed by
+  // the rest; returns the number kept. With dropRest the rest is discarded.
+  template <class Pred>
+  size_t split(Edge *first, size_t n, Pred keep, bool dropRest)
+  {
+    if (n < PARALLEL_MIN)
+    {
+      if (dropRest)
+        return std::remove_if(first, first + n, [&](const Edge &e) { return !keep(e); }) - first;
+      return std::stable_partition(first, first + n, keep) - first;
+    }
+
+    std::vector<size_t> keptStart(nTasks_ + 1, 0), restStart(nTasks_ + 1, 0);
+    poolFor(pool_, nTasks_, n, [&](size_t begin, size_t end, size_t t) {
+      size_t count = 0;
+      for (size_t i = begin; i < end; ++i)
+        count += keep(first[i]);
+      keptStart[t + 1] = count;
+      restStart[t + 1] = (end - begin) - count;
+    });
+    for (size_t t = 0; t < nTasks_; ++t)
+    {
+      keptStart[t + 1] += keptStart[t];
+      restStart[t + 1] += restStart[t];
+    }
+    size_t kept = keptStart[nTasks_];
+    size_t total = dropRest ? kept : n;
+    Edge *tmp = scratch_.data();
+    poolFor(pool_, nTasks_, n, [&](size_t begin, size_t end, size_t t) {
+      size_t k = keptStart[t], r = kept + restStart[t];
+      for (size_t i = begin; i < end; ++i)
+      {
+        if (keep(first[i]))
+          tmp[k++] = first[i];
+        else if (!dropRest)
+          tmp[r++] = first[i];
+      }
+    });
+    poolFor(pool_, nTasks_, total, [&](size_t begin, size_t end, size_t) {
+      std::copy(tmp + begin, tmp + end, first + begin);
+    });
+    return kept;
+  }
+
+  // Drops edges whose endpoints are already connected
+  size_t filter(Edge *first, size_t n)
+  {
+    size_t kept = split(first, n, [&](const Edge &e) { return !sets_.connected(e.src, e.dest); }, true);
+    filteredEdges_ += n - kept;
+    return kept;
+  }
+
+  void run(Edge *first, size_t n)
+  {
+    if (complete() || n == 0)
+      return;
+    if (n <= BASE_CASE)
+    {
+      kruskal(first, n);
+      return;
+    }
+
+    W pivot = pickPivot(first, n);
+    size_t light = split(first, n, [pivot](const Edge &e) { return !(pivot < e.weight); }, false);
+    if (light == n)
+    {
+      // Pivot is the maximum: split off the edges strictly below it; the rest
+      // all weigh exactly pivot and can be taken in any order
+      light = split(first, n, [pivot](const Edge &e) { return e.weight < pivot; }, false);
+      run(first, light);
+      for (size_t i = light; i < n && !complete(); ++i)
+        take(first[i]);
+      return;
+    }
+    run(first, light);
+    if (complete())
+      return;
+    size_t heavy = filter(first + light, n - light);
+    run(first + light, heavy);
+  }
+
+public:
+  FilterKruskal(V numVertices, ThreadPool &pool, size_t nTasks)
+      : pool_(pool), nTasks_(nTasks < 1 ? 1 : nTasks), sets_(numVertices),
+        treeEdges_(numVertices > 0 ? numVertices - 1 : 0), rng_(numVertices)
+  {
+  }
+
+  // Returns the minimum spanning forest of edges (which is reordered)
+  std::vector<Edge> run(PolicyVector<Edge> &edges)
+  {
+    scratch_.resize(edges.size());
+    run(edges.data(), edges.size());
+    PolicyVector<Edge>().swap(scratch_);
+    return std::move(forest_);
+  }
+
+  uint64_t sortedEdges() const { return sortedEdges_; }
+  uint64_t filteredEdges() const { return filteredEdges_; }
+};
+
+#endif
@@ -1,5 +1,8 @@
 #ifndef GRAPH_H
 #define GRAPH_H
+#include "graph_binary.h"
+#include "graph_types.h"
+#include "memory_policy.h"
 #include "quick_sort.h"
 #include "utils.h"
 #include <iostream>
@@ -8,111 +11,248 @@
 #include <limits>
 #include <string>
 #include <algorithm>
-#include <sstream>
+#include <stdexcept>
+#include <memory>
+#include <cstring>
+#include <type_traits>
 
+// Adjacency entry: neighbor id and edge weight packed together (without
+// padding) so that a relaxation loop reads both from the same cache line and
+// narrow weight types actually shrink the adjacency array.
+#pragma pack(push, 1)
+template <class V, class W>
+struct WeightedNeighbor
+{
+  V vertex;
+  W weight;
+};
+#pragma pack(pop)
+
+// Contiguous view over the adjacency entries of a single vertex
+template <class V, class W>
+struct NeighborRange
+{
+  const WeightedNeighbor<V, W> *begin_;
+  const WeightedNeighbor<V, W> *end_;
+
+  const WeightedNeighbor<V, W> *begin() const { return begin_; }
+  const WeightedNeighbor<V, W> *end() const { return end_; }
+  size_t size() const { return end_ - begin_; }
+  bool empty() const { return begin_ == end_; }
+};
+
+// Undirected weighted graph stored in compressed sparse row (CSR) form,
+// templated on the vertex-id type V and the edge weight type W (see
+// graph_types.h for the supported instantiations). The adjacency of vertex u
+// is adjacency_[offsets_[u] .. offsets_[u+1]), with each entry holding the
+// neighbor together with the edge weight, so memory is O(V + E). Offsets are
+// always 64-bit so graphs with more than 2^32 adjacency entries work.
+//
+// The arrays are either owned by the Graph (built by GraphBuilder, see
+// graph_builder.h) or point into a read-only mmap of a binary graph file
+// (see graph_binary.h).
+// Bounds checks on the public accessors are only compiled in when
+// GRAPH_BOUNDS_CHECK is defined (make DEBUG=1).
+template <class V, class W>
 class Graph
 {
+public:
+  typedef V VertexType;
+  typedef W WeightType;
+  typedef WeightedNeighbor<V, W> Neighbor;
+
 private:
-  std::vector<std::vector<WeightType>> adjMatrix_;
-  std::vector<std::vector<uintV>> neighbors_;
+  const uint64_t *offsets_ = nullptr;
+  const Neighbor *adjacency_ = nullptr;
 
-public:
-  uintV numVertices_;
-  Graph() = default;
+  PolicyVector<uint64_t> offsetsStorage_;
+  PolicyVector<Neighbor> adjacencyStorage_;
+  std::unique_ptr<MappedFile> mapping_;
 
-  void initializeGraph(uintV numVertices)
+  bool outOfBounds(V node) const
   {
-    numVertices_ = numVertices;
-    adjMatrix_.assign(numVertices, std::vector<WeightType>(numVertices, MAX_WEIGHT));
-    neighbors_.assign(numVertices, std::vector<uintV>());
-
-    for (uintV i = 0; i < numVertices_; ++i)
+#ifdef GRAPH_BOUNDS_CHECK
+    if (node >= numVertices_)
     {
-      adjMatrix_[i][i] = 0; // Initialize self-loops to 0
+      std::cerr << "Error: Vertex index out of bounds." << std::endl;
+      return true;
     }
+#else
+    (void)node;
+#endif
+    return false;
   }
 
-  template <class T>
-  void readGraphFromBinary(const std::string &inputFilePath) {
-    std::ifstream inputFile(inputFilePath);
-    if (!inputFile.is_open()) {
-        std::cerr << "Error opening input file: " << inputFilePath << std::endl;
-        throw std::runtime_error("Failed to open input file");
-    }
+public:
+  V numVertices_ = 0;
+  Graph() = default;
+  Graph(const Graph &) = delete;
+  Graph &operator=(const Graph &) = delete;
+  Graph(Graph &&) = default;
+  Graph &operator=(Graph &&) = default;
 
-    std::string line;
-    uintV src, dest, maxVertexId = 0;
-    WeightType weight; // Assuming WeightType is known and appropriate for your graph
+  // Takes ownership of already-built CSR arrays (offsets has numVertices + 1
+  // entries, adjacency holds the rows back to back)
+  void adoptCSR(V numVertices, PolicyVector<uint64_t> &&offsets, PolicyVector<Neighbor> &&adjacency)
+  {
+    mapping_.reset();
+    numVertices_ = numVertices;
+    offsetsStorage_ = std::move(offsets);
+    adjacencyStorage_ = std::move(adjacency);
+    offsets_ = offsetsStorage_.data();
+    adjacency_ = adjacencyStorage_.data();
+  }
 
-    // Temporary storage to avoid resizing vectors multiple times
-    std::vector<std::tuple<uintV, uintV, WeightType>> edges;
+  // Maps a binary graph file written by writeGraphToBinary() and points the
+  // CSR arrays directly into the mapping; nothing is copied or parsed.
+  void readGraphFromBinary(const std::string &inputFilePath, bool verifyChecksum = false)
+  {
+    std::unique_ptr<MappedFile> mapping(new MappedFile(inputFilePath));
+    if (mapping->size() < sizeof(GraphFileHeader))
+      throw std::runtime_error("Binary graph file is truncated");
 
-    // Skip the header line
-    std::getline(inputFile, line);
+    GraphFileHeader header;
+    std::memcpy(&header, mapping->data(), sizeof(header));
+    if (std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0)
+      throw std::runtime_error("Not a binary graph file");
+    if (header.version != GRAPH_FILE_VERSION)
+      throw std::runtime_error("Unsupported binary graph file version");
+    if (header.vertexBytes != sizeof(V) || header.weightBytes != sizeof(W) ||
+        header.offsetBytes != sizeof(uint64_t) ||
+        ((header.flags & GRAPH_FILE_FLOAT_WEIGHTS) != 0) != std::is_floating_point<W>::value)
+      throw std::runtime_error("Binary graph file was written with different vertex/weight types");
 
-    while (std::getline(inputFile, line)) {
-        std::istringstream iss(line);
-        if (!(iss >> src >> dest >> weight)) {
-            // Handle error or ignore malformed line
-            continue;
-        }
+    uint64_t offsetsBytes = (header.numVertices + 1) * sizeof(uint64_t);
+    uint64_t adjacencyStart = GRAPH_FILE_HEADER_BYTES + alignUp(offsetsBytes, GRAPH_FILE_ALIGN);
+    uint64_t adjacencyBytes = header.numEdges * sizeof(Neighbor);
+    if (mapping->size() < adjacencyStart + adjacencyBytes)
+      throw std::runtime_error("Binary graph file is truncated");
 
-        edges.emplace_back(src, dest, weight);
-        maxVertexId = std::max({maxVertexId, src, dest});
+    const char *base = mapping->data();
+    if (verifyChecksum)
+    {
+      uint64_t hash = graphChecksum(base + GRAPH_FILE_HEADER_BYTES, offsetsBytes);
+      hash = graphChecksum(base + adjacencyStart, adjacencyBytes, hash);
+      if (hash != header.checksum)
+        throw std::runtime_error("Binary graph file checksum mismatch");
     }
 
-    // Initialize the Graph structure based on the maxVertexId
-    numVertices_ = maxVertexId + 1;
-    adjMatrix_.assign(numVertices_, std::vector<WeightType>(numVertices_, MAX_WEIGHT));
-    neighbors_.assign(numVertices_, std::vector<uintV>());
+    offsetsStorage_.clear();
+    offsetsStorage_.shrink_to_fit();
+    adjacencyStorage_.clear();
+    adjacencyStorage_.shrink_to_fit();
+    numVertices_ = (V)header.numVertices;
+    offsets_ = reinterpret_cast<const uint64_t *>(base + GRAPH_FILE_HEADER_BYTES);
+    adjacency_ = reinterpret_cast<const Neighbor *>(base + adjacencyStart);
+    mapping_ = std::move(mapping);
+  }
 
-    for (size_t i = 0; i < numVertices_; ++i) {
-        adjMatrix_[i][i] = 0; // Initialize self-loops to 0, if necessary
+  // Writes the graph in the binary CSR format understood by readGraphFromBinary()
+  void writeGraphToBinary(const std::string &outputFilePath) const
+  {
+    std::ofstream out(outputFilePath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      std::cerr << "Error opening output file: " << outputFilePath << std::endl;
+      throw std::runtime_error("Failed to open output file");
     }
 
-    // Add edges to the graph
-    for (const auto& edge : edges) {
-        this->addEdge(std::get<0>(edge), std::get<1>(edge), std::get<2>(edge));
-    }
-}
+    uint64_t offsetsBytes = (uint64_t(numVertices_) + 1) * sizeof(uint64_t);
+    uint64_t adjacencyBytes = numEdges() * sizeof(Neighbor);
+
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.flags = std::is_floating_point<W>::value ? GRAPH_FILE_FLOAT_WEIGHTS : 0;
+    header.vertexBytes = sizeof(V);
+    header.weightBytes = sizeof(W);
+    header.offsetBytes = sizeof(uint64_t);
+    header.numVertices = numVertices_;
+    header.numEdges = numEdges();
+    header.checksum = graphChecksum(adjacency_, adjacencyBytes,
+                                    graphChecksum(offsets_, offsetsBytes));
+
+    static const char padding[GRAPH_FILE_ALIGN] = {0};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(offsets_), offsetsBytes);
+    out.write(padding, alignUp(offsetsBytes, GRAPH_FILE_ALIGN) - offsetsBytes);
+    out.write(reinterpret_cast<const char *>(adjacency_), adjacencyBytes);
+    if (!out)
+      throw std::runtime_error("Failed to write binary graph file");
+  }
 
-  void addEdge(uintV src, uintV dest, WeightType weight)
+  bool isMapped() const
   {
-    if (src >= numVertices_ || dest >= numVertices_)
-    {
-      std::cerr << "Error: Vertex index out of bounds." << std::endl;
-      return;
-    }
-    adjMatrix_[src][dest] = weight;
-    adjMatrix_[dest][src] = weight;
-    neighbors_[src].push_back(dest);
-    neighbors_[dest].push_back(src);
+    return mapping_ != nullptr;
   }
 
-  const std::vector<uintV> &getNeighbors(uintV node) const
+  NeighborRange<V, W> getNeighbors(V node) const
   {
-    if (node >= numVertices_)
-    {
-      std::cerr << "Error: Vertex index out of bounds." << std::endl;
-      static const std::vector<uintV> empty;
-      return empty; // Safely return an empty vector for out of bounds access
-    }
-    return neighbors_[node];
+    if (outOfBounds(node))
+      return NeighborRange<V, W>{nullptr, nullptr}; // Safely return an empty range for out of bounds access
+    return NeighborRange<V, W>{adjacency_ + offsets_[node],
+                               adjacency_ + offsets_[node + 1]};
+  }
+
+  // Calls f(neighbor, weight) for every edge incident to node
+  template <class F>
+  void forEachNeighbor(V node, F &&f) const
+  {
+    for (const Neighbor &nbr : getNeighbors(node))
+      f(V(nbr.vertex), W(nbr.weight));
   }
 
-  uintV numVertices() const
+  V numVertices() const
   {
     return numVertices_;
   }
 
-  WeightType getEdgeWeight(uintV src, uintV dest) const
+  // Number of directed adjacency entries (each undirected edge counts twice)
+  uint64_t numEdges() const
   {
-    if (src >= numVertices_ || dest >= numVertices_)
-    {
-      std::cerr << "Error: Vertex index out of bounds." << std::endl;
-      return MAX_WEIGHT;
+    return offsets_ == nullptr ? 0 : offsets_[numVertices_];
+  }
+
+  // Returns the lightest (src, dest) edge weight by scanning src's row.
+  // Prefer getNeighbors()/forEachNeighbor() in hot loops.
+  W getEdgeWeight(V src, V dest) const
+  {
+    if (outOfBounds(src) || outOfBounds(dest))
+      return maxWeight<W>();
+    if (src == dest)
+      return 0;
+    W best = maxWeight<W>();
+    for (const Neighbor &nbr : getNeighbors(src)) {
+      if (nbr.vertex == dest && nbr.weight < best)
+        best = nbr.weight;
     }
-    return adjMatrix_[src][dest];
+    return best;
   }
 };
-#endif
\ No newline at end of file
+
+template <class V, class W>
+void printGraphTypes(const Graph<V, W> &)
+{
+  std::cout << "Vertex type : " << typeName<V>() << std::endl;
+  std::cout << "Weight type : " << typeName<W>() << std::endl;
+}
+
+// Smallest and largest edge weight, or (0, 0) without edges. GraphT is Graph
+// or CompressedGraph.
+template <class GraphT>
+std::pair<typename GraphT::WeightType, typename GraphT::WeightType> graphWeightRange(const GraphT &g)
+{
+  typedef typename GraphT::VertexType V;
+  typedef typename GraphT::WeightType W;
+  W lo = 0, hi = 0;
+  bool first = true;
+  for (V u = 0; u < g.numVertices(); ++u)
+    g.forEachNeighbor(u, [&](V, W w) {
+      if (first || w < lo) lo = w;
+      if (first || w > hi) hi = w;
+      first = false;
+    });
+  return std::make_pair(lo, hi);
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef GRAPH_BINARY_H
+#define GRAPH_BINARY_H
+#include "graph_types.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// On-disk CSR graph format (little endian, native struct layout):
+//
+//   [GraphFileHeader]                         GRAPH_FILE_HEADER_BYTES bytes
+//   [offsets]     (numVertices + 1) * offsetBytes, padded to GRAPH_FILE_ALIGN
+//   [adjacency]   numEdges * (vertexBytes + weightBytes) packed
+//                 {neighbor, weight} entries
+//
+// vertexBytes, weightBytes and the GRAPH_FILE_FLOAT_WEIGHTS flag select the
+// Graph<V, W> instantiation the file is loaded into (see graph_types.h).
+//
+// Sections are aligned so the loader can point the Graph's arrays straight
+// into a read-only mmap of the file.
+
+#define GRAPH_FILE_MAGIC "MSTCSR\0"
+#define GRAPH_FILE_VERSION 2
+#define GRAPH_FILE_ALIGN 64
+#define GRAPH_FILE_HEADER_BYTES 64
+
+// Header flag bits
+#define GRAPH_FILE_FLOAT_WEIGHTS 0x1
+
+struct GraphFileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint32_t vertexBytes;
+  uint32_t weightBytes;
+  uint32_t offsetBytes;
+  uint32_t reserved0;
+  uint64_t numVertices;
+  uint64_t numEdges; // directed adjacency entries
+  uint64_t checksum; // over the offsets and adjacency sections
+  uint64_t reserved1;
+};
+static_assert(sizeof(GraphFileHeader) == GRAPH_FILE_HEADER_BYTES,
+              "GraphFileHeader must stay 64 bytes");
+
+inline uint64_t alignUp(uint64_t n, uint64_t alignment)
+{
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+// Word-wise FNV-1a style checksum; cheap enough to run over multi-GB files
+inline uint64_t graphChecksum(const void *data, size_t bytes, uint64_t hash = 1469598103934665603ULL)
+{
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  size_t words = bytes / sizeof(uint64_t);
+  for (size_t i = 0; i < words; ++i)
+  {
+    uint64_t w;
+    std::memcpy(&w, p + i * sizeof(uint64_t), sizeof(uint64_t));
+    hash = (hash ^ w) * 1099511628211ULL;
+  }
+  for (size_t i = words * sizeof(uint64_t); i < bytes; ++i)
+    hash = (hash ^ p[i]) * 1099511628211ULL;
+  return hash;
+}
+
+inline bool hasGraphFileMagic(const std::string &path)
+{
+  char magic[8] = {0};
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  ssize_t n = ::read(fd, magic, sizeof(magic));
+  ::close(fd);
+  return n == (ssize_t)sizeof(magic) && std::memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+inline GraphFileHeader readGraphFileHeader(const std::string &path)
+{
+  GraphFileHeader header;
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "Error opening input file: " << path << std::endl;
+    throw std::runtime_error("Failed to open input file");
+  }
+  ssize_t n = ::read(fd, &header, sizeof(header));
+  ::close(fd);
+  if (n != (ssize_t)sizeof(header) || std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0)
+    throw std::runtime_error("Not a binary graph file");
+  if (header.version != GRAPH_FILE_VERSION)
+    throw std::runtime_error("Unsupported binary graph file version");
+  return header;
+}
+
+inline GraphTypeInfo graphTypesFromHeader(const GraphFileHeader &header)
+{
+  GraphTypeInfo info;
+  if (header.vertexBytes != 4 && header.vertexBytes != 8)
+    throw std::runtime_error("Unsupported vertex id width in binary graph file");
+  info.wideVertices = header.vertexBytes == 8;
+  bool real = (header.flags & GRAPH_FILE_FLOAT_WEIGHTS) != 0;
+  if (real && header.weightBytes == 4)
+    info.weight = WeightKind::Float;
+  else if (real && header.weightBytes == 8)
+    info.weight = WeightKind::Double;
+  else if (!real && header.weightBytes == 2)
+    info.weight = WeightKind::Int16;
+  else if (!real && header.weightBytes == 4)
+    info.weight = WeightKind::Int32;
+  else
+    throw std::runtime_error("Unsupported weight type in binary graph file");
+  return info;
+}
+
+// Read-only memory mapping of a whole file. Pages come from the page cache,
+// so repeated runs on the same graph share them.
+class MappedFile
+{
+private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+
+public:
+  explicit MappedFile(const std::string &path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      std::cerr << "Error opening input file: " << path << std::endl;
+      throw std::runtime_error("Failed to open input file");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+      ::close(fd);
+      throw std::runtime_error("Failed to stat input file");
+    }
+    size_ = st.st_size;
+    if (size_ > 0)
+    {
+      data_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (data_ == MAP_FAILED)
+      {
+        data_ = nullptr;
+        ::close(fd);
+        throw std::runtime_error("Failed to mmap input file");
+      }
+    }
+    ::close(fd);
+  }
+
+  ~MappedFile()
+  {
+    if (data_)
+      ::munmap(data_, size_);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return static_cast<const char *>(data_); }
+  size_t size() const { return size_; }
+};
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef GRAPH_BUILDER_H
+#define GRAPH_BUILDER_H
+#include "edge_list_parser.h"
+#include "graph.h"
+#include "graph_binary.h"
+#include "graph_types.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct CanonicalizeStats
+{
+  size_t selfLoops = 0;
+  size_t duplicates = 0; // undirected edges dropped as repeats
+};
+
+// Builds a Graph<V, W> straight into its CSR arrays, without keeping an edge
+// list next to the graph. Edges can be fed in one of two ways:
+//
+//   Two-pass (inputs that can be replayed, e.g. a mapped file):
+//     GraphBuilder<V, W> b(numVertices);
+//     for each edge: b.countEdge(src, dest);
+//     b.allocate();
+//     for each edge: b.addEdge(src, dest, weight);
+//     Graph<V, W> g = b.build(nThreads);
+//   countEdge() and addEdge() may be called concurrently from several
+//   threads. Peak memory is the adjacency array plus two counters per vertex.
+//
+//   Single pass (pipes, generators):
+//     GraphBuilder<V, W> b;          // or b(numVertices) if it is known
+//     b.reserve(numEdges);           // optional, if the count is known
+//     for each edge: b.appendEdge(src, dest, weight);
+//     Graph<V, W> g = b.build(nThreads);
+//   Edges are buffered in packed (V, V, W) form and scattered into rows by
+//   build(); the vertex count grows with the largest id seen.
+//
+// Every edge is inserted in both directions. build() then canonicalizes each
+// row: self-loops are dropped (already at insertion), the row is sorted by
+// neighbour id, and repeated neighbours collapse into the lightest entry.
+// Since both directions of an edge see the same set of weights, the rows stay
+// symmetric. Edges with an id outside [0, numVertices) are skipped.
+template <class V, class W>
+class GraphBuilder
+{
+public:
+  typedef WeightedNeighbor<V, W> Neighbor;
+
+private:
+#pragma pack(push, 1)
+  struct PendingEdge
+  {
+    V src;
+    V dest;
+    W weight;
+  };
+#pragma pack(pop)
+
+  uint64_t numVertices_ = 0;
+  bool sized_ = false;
+  std::unique_ptr<std::atomic<uint64_t>[]> cursor_; // degrees, then insertion points
+  std::vector<uint64_t> offsets_;
+  PolicyVector<Neighbor> adjacency_;
+  std::vector<PendingEdge> pending_;
+  std::atomic<uint64_t> selfLoops_{0};
+  std::atomic<uint64_t> outOfRange_{0};
+  CanonicalizeStats stats_;
+
+  bool accept(uint64_t src, uint64_t dest)
+  {
+    return src < numVertices_ && dest < numVertices_ && src != dest;
+  }
+
+  // Like accept(), but also tallies rejected edges for stats() and the
+  // out-of-bounds report; called once per input edge
+  bool acceptCounted(uint64_t src, uint64_t dest)
+  {
+    if (src >= numVertices_ || dest >= numVertices_)
+    {
+      outOfRange_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (src == dest)
+    {
+      selfLoops_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  void countDegrees()
+  {
+    cursor_.reset(new std::atomic<uint64_t>[numVertices_ + 1]());
+  }
+
+public:
+  GraphBuilder() = default;
+
+  explicit GraphBuilder(uint64_t numVertices) : numVertices_(numVertices), sized_(true)
+  {
+    if (numVertices > std::numeric_limits<V>::max())
+      throw std::runtime_error("Vertex ids do not fit the graph's vertex type");
+    countDegrees();
+  }
+
+  // First pass: records one edge towards the degrees of src and dest
+  void countEdge(uint64_t src, uint64_t dest)
+  {
+    if (!acceptCounted(src, dest))
+      return;
+    cursor_[src].fetch_add(1, std::memory_order_relaxed);
+    cursor_[dest].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Ends the counting pass: lays out the rows and sizes the adjacency array
+  void allocate()
+  {
+    offsets_.assign(numVertices_ + 1, 0);
+    for (uint64_t u = 0; u < numVertices_; ++u)
+    {
+      offsets_[u + 1] = offsets_[u] + cursor_[u].load(std::memory_order_relaxed);
+      cursor_[u].store(offsets_[u], std::memory_order_relaxed);
+    }
+    adjacency_.resize(offsets_[numVertices_]);
+  }
+
+  // Second pass: stores the edge in the rows of src and dest. Must see the
+  // same edges as the counting pass.
+  void addEdge(uint64_t src, uint64_t dest, W weight)
+  {
+    if (!accept(src, dest))
+      return;
+    adjacency_[cursor_[src].fetch_add(1, std::memory_order_relaxed)] = Neighbor{(V)dest, weight};
+    adjacency_[cursor_[dest].fetch_add(1, std::memory_order_relaxed)] = Neighbor{(V)src, weight};
+  }
+
+  void reserve(uint64_t numEdges)
+  {
+    pending_.reserve(numEdges);
+  }
+
+  // Single-pass input; not thread safe
+  void appendEdge(uint64_t src, uint64_t dest, W weight)
+  {
+    if (!sized_)
+    {
+      uint64_t top = std::max(src, dest);
+      if (top >= std::numeric_limits<V>::max())
+        throw std::runtime_error("Vertex ids do not fit the graph's vertex type");
+      numVertices_ = std::max(numVertices_, top + 1);
+    }
+    if (acceptCounted(src, dest))
+      pending_.push_back(PendingEdge{(V)src, (V)dest, weight});
+  }
+
+  const CanonicalizeStats &stats() const
+  {
+    return stats_;
+  }
+
+  // Canonicalizes the rows and hands the CSR arrays to a Graph. The builder
+  // is left empty.
+  Graph<V, W> build(uintE nThreads = 1)
+  {
+    if (!pending_.empty() || offsets_.empty())
+    {
+      // Single-pass input: count and scatter from the buffer
+      countDegrees();
+      for (const PendingEdge &e : pending_)
+      {
+        cursor_[e.src].fetch_add(1, std::memory_order_relaxed);
+        cursor_[e.dest].fetch_add(1, std::memory_order_relaxed);
+      }
+      allocate();
+      for (const PendingEdge &e : pending_)
+        addEdge(e.src, e.dest, e.weight);
+      std::vector<PendingEdge>().swap(pending_);
+    }
+    cursor_.reset();
+    if (outOfRange_ > 0)
+      std::cerr << "Error: Vertex index out of bounds (" << outOfRange_ << " edges skipped)." << std::endl;
+
+    // Sort each row and keep the first (lightest) entry per neighbour,
+    // compacting the row towards its start
+    uint64_t n = numVertices_;
+    PolicyVector<uint64_t> kept(n + 1, 0);
+    if (nThreads < 1)
+      nThreads = 1;
+    runOnThreads(nThreads, [&](uintE t) {
+      uint64_t begin = n * t / nThreads;
+      uint64_t end = n * (t + 1) / nThreads;
+      for (uint64_t u = begin; u < end; ++u)
+      {
+        Neighbor *row = adjacency_.data() + offsets_[u];
+        Neighbor *rowEnd = adjacency_.data() + offsets_[u + 1];
+        std::sort(row, rowEnd, [](const Neighbor &a, const Neighbor &b) {
+          if (a.vertex != b.vertex)
+            return a.vertex < b.vertex;
+          return a.weight < b.weight;
+        });
+        Neighbor *out = row;
+        for (Neighbor *p = row; p < rowEnd; ++p)
+          if (p == row || p->vertex != (out - 1)->vertex)
+            *out++ = *p;
+        kept[u + 1] = out - row;
+      }
+    });
+
+    // Close the gaps left by dropped entries; rows only move left
+    uint64_t total = offsets_[n];
+    for (uint64_t u = 0; u < n; ++u)
+    {
+      kept[u + 1] += kept[u];
+      std::copy(adjacency_.begin() + offsets_[u], adjacency_.begin() + offsets_[u] + (kept[u + 1] - kept[u]),
+                adjacency_.begin() + kept[u]);
+    }
+    adjacency_.resize(kept[n]);
+    adjacency_.shrink_to_fit();
+    std::vector<uint64_t>().swap(offsets_);
+
+    stats_.selfLoops = selfLoops_;
+    stats_.duplicates = (total - kept[n]) / 2;
+
+    Graph<V, W> g;
+    g.adoptCSR((V)n, std::move(kept), std::move(adjacency_));
+    adjacency_ = PolicyVector<Neighbor>();
+    return g;
+  }
+};
+
+// Builds a Graph<V, W> from a text edge list with the two-pass builder. The
+// file is mapped once and parsed in parallel for each pass.
+template <class V, class W>
+Graph<V, W> buildGraphFromText(const TextEdgeList &edges, uint64_t numVertices, uintE nThreads,
+                               CanonicalizeStats *stats = nullptr)
+{
+  GraphBuilder<V, W> builder(numVertices);
+  edges.forEachEdge([&](uint64_t src, uint64_t dest, double) { builder.countEdge(src, dest); });
+  builder.allocate();
+  edges.forEachEdge([&](uint64_t src, uint64_t dest, double weight) { builder.addEdge(src, dest, (W)weight); });
+  Graph<V, W> g = builder.build(nThreads);
+  if (stats)
+    *stats = builder.stats();
+  return g;
+}
+
+// Loads inputFilePath into the Graph<V, W> instantiation that fits it and
+// calls f(graph). Binary files name their types in the header; for text
+// files the narrowest types covering the id and weight ranges are used (see
+// chooseGraphTypes()), and the graph is built by GraphBuilder so every
+// undirected edge appears exactly once per direction.
+template <class F>
+void loadGraph(const std::string &inputFilePath, uintE nThreads, F &&f)
+{
+  if (hasGraphFileMagic(inputFilePath))
+  {
+    GraphTypeInfo info = graphTypesFromHeader(readGraphFileHeader(inputFilePath));
+    dispatchGraphTypes(info, [&](auto vertexTag, auto weightTag) {
+      Graph<typename decltype(vertexTag)::type, typename decltype(weightTag)::type> g;
+      g.readGraphFromBinary(inputFilePath);
+      f(g);
+    });
+  }
+  else
+  {
+    TextEdgeList edges(inputFilePath, nThreads);
+    EdgeListSummary summary = edges.summarize();
+    dispatchGraphTypes(summary.types(), [&](auto vertexTag, auto weightTag) {
+      typedef typename decltype(vertexTag)::type V;
+      typedef typename decltype(weightTag)::type W;
+      Graph<V, W> g = buildGraphFromText<V, W>(edges, summary.maxVertexId + 1, nThreads);
+      f(g);
+    });
+  }
+}
+
+#endif
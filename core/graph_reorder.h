@@ -0,0 +1,291 @@
+#ifndef GRAPH_REORDER_H
+#define GRAPH_REORDER_H
+#include "graph.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+// Locality-improving vertex relabelling. Road networks arrive with arbitrary
+// ids, so Prim's frontier jumps around the per-vertex arrays; relabelling
+// vertices so that neighbours get nearby ids keeps those accesses in cache.
+//
+//   bfs    : breadth-first order from vertex 0 (then each remaining component)
+//   rcm    : reverse Cuthill-McKee (BFS from low-degree vertices, neighbours
+//            visited by increasing degree, final order reversed)
+//   degree : by decreasing degree, hubs first
+//
+// The MST is computed on the relabelled graph and VertexOrdering maps ids
+// back when results are written. Permutations are cached next to the input
+// file (<inputFile>.perm.<kind>) so the ordering is only computed once.
+
+enum class ReorderKind { None, BFS, RCM, Degree };
+
+inline ReorderKind reorderKindFromName(const std::string &name)
+{
+  if (name == "none") return ReorderKind::None;
+  if (name == "bfs") return ReorderKind::BFS;
+  if (name == "rcm") return ReorderKind::RCM;
+  if (name == "degree") return ReorderKind::Degree;
+  throw std::invalid_argument("Unknown reorder kind: " + name);
+}
+
+inline const char *reorderKindName(ReorderKind kind)
+{
+  switch (kind)
+  {
+  case ReorderKind::BFS: return "bfs";
+  case ReorderKind::RCM: return "rcm";
+  case ReorderKind::Degree: return "degree";
+  default: return "none";
+  }
+}
+
+// Maps ids of a relabelled graph back to the ids of the input file
+template <class V>
+struct VertexOrdering
+{
+  std::vector<V> toOriginal; // empty means the identity mapping
+
+  V original(V v) const
+  {
+    return toOriginal.empty() ? v : toOriginal[v];
+  }
+};
+
+template <class V, class W>
+V vertexDegree(const Graph<V, W> &g, V v)
+{
+  return (V)g.getNeighbors(v).size();
+}
+
+// Appends the BFS order of the component containing root to order
+template <class V, class W>
+void bfsFrom(const Graph<V, W> &g, V root, std::vector<bool> &visited,
+             std::vector<V> &order, bool byDegree)
+{
+  size_t head = order.size();
+  visited[root] = true;
+  order.push_back(root);
+  std::vector<V> next;
+  while (head < order.size())
+  {
+    V u = order[head++];
+    next.clear();
+    for (const auto &nbr : g.getNeighbors(u))
+    {
+      V v = nbr.vertex;
+      if (!visited[v])
+      {
+        visited[v] = true;
+        next.push_back(v);
+      }
+    }
+    if (byDegree)
+    {
+      std::stable_sort(next.begin(), next.end(), [&](V a, V b) {
+        return vertexDegree(g, a) < vertexDegree(g, b);
+      });
+    }
+    order.insert(order.end(), next.begin(), next.end());
+  }
+}
+
+// Returns newId, where newId[old] is the relabelled id of vertex old
+template <class V, class W>
+std::vector<V> computeOrdering(const Graph<V, W> &g, ReorderKind kind)
+{
+  V n = g.numVertices();
+  std::vector<V> order;
+  order.reserve(n);
+
+  if (kind == ReorderKind::Degree)
+  {
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](V a, V b) {
+      return vertexDegree(g, a) > vertexDegree(g, b);
+    });
+  }
+  else if (kind == ReorderKind::BFS)
+  {
+    std::vector<bool> visited(n, false);
+    for (V v = 0; v < n; ++v)
+      if (!visited[v])
+        bfsFrom(g, v, visited, order, false);
+  }
+  else if (kind == ReorderKind::RCM)
+  {
+    // Start every component from its lowest-degree vertex
+    std::vector<V> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), [&](V a, V b) {
+      return vertexDegree(g, a) < vertexDegree(g, b);
+    });
+    std::vector<bool> visited(n, false);
+    for (V v : starts)
+      if (!visited[v])
+        bfsFrom(g, v, visited, order, true);
+    std::reverse(order.begin(), order.end());
+  }
+  else
+  {
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+  }
+
+  std::vector<V> newId(n);
+  for (V i = 0; i < n; ++i)
+    newId[order[i]] = i;
+  return newId;
+}
+
+// Builds the graph with every vertex v renamed to newId[v]. Rows are sorted
+// by neighbour id so each row is also scanned in memory order.
+template <class V, class W>
+Graph<V, W> relabelGraph(const Graph<V, W> &g, const std::vector<V> &newId, uintE nThreads)
+{
+  typedef typename Graph<V, W>::Neighbor Neighbor;
+  V n = g.numVertices();
+  std::vector<V> oldId(n);
+  for (V v = 0; v < n; ++v)
+    oldId[newId[v]] = v;
+
+  PolicyVector<uint64_t> offsets(uint64_t(n) + 1, 0);
+  for (V v = 0; v < n; ++v)
+    offsets[v + 1] = offsets[v] + g.getNeighbors(oldId[v]).size();
+
+  PolicyVector<Neighbor> adjacency(offsets[n]);
+  if (nThreads < 1)
+    nThreads = 1;
+  runOnThreads(nThreads, [&](uintE t) {
+    V begin = (V)(uint64_t(n) * t / nThreads);
+    V end = (V)(uint64_t(n) * (t + 1) / nThreads);
+    for (V v = begin; v < end; ++v)
+    {
+      uint64_t out = offsets[v];
+      for (const Neighbor &nbr : g.getNeighbors(oldId[v]))
+        adjacency[out++] = Neighbor{newId[nbr.vertex], nbr.weight};
+      std::sort(adjacency.begin() + offsets[v], adjacency.begin() + offsets[v + 1],
+                [](const Neighbor &a, const Neighbor &b) { return a.vertex < b.vertex; });
+    }
+  });
+
+  Graph<V, W> relabelled;
+  relabelled.adoptCSR(n, std::move(offsets), std::move(adjacency));
+  return relabelled;
+}
+
+#define PERM_FILE_MAGIC "MSTPERM"
+
+// Identifies the graph a cached permutation belongs to
+struct PermFileHeader
+{
+  char magic[8];
+  uint32_t kind;
+  uint32_t vertexBytes;
+  uint64_t numVertices;
+  uint64_t numEdges;
+  uint64_t inputSize;
+  int64_t inputMtime;
+};
+
+inline bool describeInputFile(const std::string &path, uint64_t &size, int64_t &mtime)
+{
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0)
+    return false;
+  size = st.st_size;
+  mtime = st.st_mtime;
+  return true;
+}
+
+template <class V, class W>
+PermFileHeader permHeaderFor(const Graph<V, W> &g, ReorderKind kind, const std::string &inputFilePath)
+{
+  PermFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, PERM_FILE_MAGIC, sizeof(header.magic));
+  header.kind = (uint32_t)kind;
+  header.vertexBytes = sizeof(V);
+  header.numVertices = g.numVertices();
+  header.numEdges = g.numEdges();
+  describeInputFile(inputFilePath, header.inputSize, header.inputMtime);
+  return header;
+}
+
+template <class V>
+bool readCachedOrdering(const std::string &permPath, const PermFileHeader &expected, std::vector<V> &newId)
+{
+  std::ifstream in(permPath, std::ios::binary);
+  if (!in.is_open())
+    return false;
+  PermFileHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(&header, &expected, sizeof(header)) != 0)
+    return false;
+  newId.resize(header.numVertices);
+  return (bool)in.read(reinterpret_cast<char *>(newId.data()), newId.size() * sizeof(V));
+}
+
+template <class V>
+void writeCachedOrdering(const std::string &permPath, const PermFileHeader &header, const std::vector<V> &newId)
+{
+  std::ofstream out(permPath, std::ios::binary | std::ios::trunc);
+  if (out.is_open())
+  {
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(newId.data()), newId.size() * sizeof(V));
+  }
+  if (!out.is_open() || !out)
+    std::cerr << "Warning: could not cache vertex ordering at " << permPath << std::endl;
+}
+
+// Relabels g according to kind (reusing a cached permutation for
+// inputFilePath when one matches) and calls f(graph, ordering). With
+// ReorderKind::None, f receives g itself and the identity ordering. The
+// input graph is released before f runs to keep peak memory down, and f may
+// in turn release the graph it is given.
+template <class V, class W, class F>
+void withReorderedGraph(Graph<V, W> &g, ReorderKind kind, const std::string &inputFilePath,
+                        uintE nThreads, F &&f)
+{
+  if (kind == ReorderKind::None)
+  {
+    f(g, VertexOrdering<V>());
+    return;
+  }
+
+  timer t1;
+  t1.start();
+  std::string permPath = inputFilePath + ".perm." + reorderKindName(kind);
+  PermFileHeader header = permHeaderFor(g, kind, inputFilePath);
+  std::vector<V> newId;
+  bool cached = readCachedOrdering(permPath, header, newId);
+  if (!cached)
+  {
+    newId = computeOrdering(g, kind);
+    writeCachedOrdering(permPath, header, newId);
+  }
+
+  Graph<V, W> relabelled = relabelGraph(g, newId, nThreads);
+  g = Graph<V, W>();
+
+  VertexOrdering<V> ordering;
+  ordering.toOriginal.resize(newId.size());
+  for (size_t v = 0; v < newId.size(); ++v)
+    ordering.toOriginal[newId[v]] = (V)v;
+  std::vector<V>().swap(newId);
+
+  std::cout << "Reorder : " << reorderKindName(kind) << (cached ? " (cached)" : "")
+            << ", time taken: " << t1.stop() << std::endl;
+  f(relabelled, ordering);
+}
+
+#endif
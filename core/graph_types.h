@@ -0,0 +1,131 @@
+#ifndef GRAPH_TYPES_H
+#define GRAPH_TYPES_H
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Vertex-id and weight types the graph and MST code are instantiated for.
+// The concrete pair is picked at load time (from the binary file header, or
+// from the id/weight ranges seen while parsing a text edge list) and
+// dispatchGraphTypes() calls into the matching template instantiation.
+//
+//   vertex ids : uint32_t, uint64_t
+//   weights    : int16_t, int32_t, float, double
+
+enum class WeightKind { Int16, Int32, Float, Double };
+
+struct GraphTypeInfo
+{
+  bool wideVertices = false; // uint64_t ids instead of uint32_t
+  WeightKind weight = WeightKind::Int32;
+};
+
+template <class T>
+struct TypeTag
+{
+  typedef T type;
+};
+
+// Accumulator type for MST totals: 64-bit integers or double
+template <class W>
+using WeightSum = typename std::conditional<std::is_floating_point<W>::value, double, long long>::type;
+
+// Sentinel meaning "no vertex" (e.g. the parent of the Prim root)
+template <class V>
+constexpr V noVertex() { return std::numeric_limits<V>::max(); }
+
+// Sentinel meaning "no edge"; never a valid edge weight
+template <class W>
+constexpr W maxWeight() { return std::numeric_limits<W>::max(); }
+
+template <class T> inline const char *typeName();
+template <> inline const char *typeName<uint32_t>() { return "uint32"; }
+template <> inline const char *typeName<uint64_t>() { return "uint64"; }
+template <> inline const char *typeName<int16_t>() { return "int16"; }
+template <> inline const char *typeName<int32_t>() { return "int32"; }
+template <> inline const char *typeName<float>() { return "float"; }
+template <> inline const char *typeName<double>() { return "double"; }
+
+template <class W> inline WeightKind weightKindOf();
+template <> inline WeightKind weightKindOf<int16_t>() { return WeightKind::Int16; }
+template <> inline WeightKind weightKindOf<int32_t>() { return WeightKind::Int32; }
+template <> inline WeightKind weightKindOf<float>() { return WeightKind::Float; }
+template <> inline WeightKind weightKindOf<double>() { return WeightKind::Double; }
+
+inline WeightKind weightKindFromName(const std::string &name)
+{
+  if (name == "int16") return WeightKind::Int16;
+  if (name == "int32") return WeightKind::Int32;
+  if (name == "float") return WeightKind::Float;
+  if (name == "double") return WeightKind::Double;
+  throw std::invalid_argument("Unknown weight type: " + name);
+}
+
+// Whether the vertex-id type (uint64_t if wideVertices) holds ids up to
+// maxVertexId. The largest id is reserved for noVertex().
+inline bool vertexTypeHolds(bool wideVertices, uint64_t maxVertexId)
+{
+  return maxVertexId < (wideVertices ? std::numeric_limits<uint64_t>::max()
+                                     : (uint64_t)std::numeric_limits<uint32_t>::max());
+}
+
+// Whether kind holds every weight in [minWeight, maxWeight] without
+// narrowing; integer kinds cannot hold fractional weights. The largest
+// value is reserved for maxWeight().
+inline bool weightKindHolds(WeightKind kind, double minWeight, double maxWeight, bool realWeights)
+{
+  switch (kind)
+  {
+  case WeightKind::Int16:
+    return !realWeights && minWeight >= std::numeric_limits<int16_t>::min() &&
+           maxWeight < std::numeric_limits<int16_t>::max();
+  case WeightKind::Int32:
+    return !realWeights && minWeight >= std::numeric_limits<int32_t>::min() &&
+           maxWeight < std::numeric_limits<int32_t>::max();
+  case WeightKind::Float:
+    return minWeight >= std::numeric_limits<float>::lowest() && maxWeight < std::numeric_limits<float>::max();
+  default:
+    return true;
+  }
+}
+
+// Narrowest types that hold the given vertex id and weight ranges
+inline GraphTypeInfo chooseGraphTypes(uint64_t maxVertexId, double minWeight,
+                                      double maxWeight, bool realWeights)
+{
+  GraphTypeInfo info;
+  info.wideVertices = !vertexTypeHolds(false, maxVertexId);
+  if (weightKindHolds(WeightKind::Int16, minWeight, maxWeight, realWeights))
+    info.weight = WeightKind::Int16;
+  else if (weightKindHolds(WeightKind::Int32, minWeight, maxWeight, realWeights))
+    info.weight = WeightKind::Int32;
+  else
+    info.weight = WeightKind::Double;
+  return info;
+}
+
+template <class V, class F>
+void dispatchWeightType(WeightKind kind, F &&f)
+{
+  switch (kind)
+  {
+  case WeightKind::Int16: f(TypeTag<V>(), TypeTag<int16_t>()); break;
+  case WeightKind::Int32: f(TypeTag<V>(), TypeTag<int32_t>()); break;
+  case WeightKind::Float: f(TypeTag<V>(), TypeTag<float>()); break;
+  case WeightKind::Double: f(TypeTag<V>(), TypeTag<double>()); break;
+  }
+}
+
+// Calls f(TypeTag<V>(), TypeTag<W>()) for the instantiation selected by info
+template <class F>
+void dispatchGraphTypes(const GraphTypeInfo &info, F &&f)
+{
+  if (info.wideVertices)
+    dispatchWeightType<uint64_t>(info.weight, f);
+  else
+    dispatchWeightType<uint32_t>(info.weight, f);
+}
+
+#endif
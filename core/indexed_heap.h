@@ -0,0 +1,132 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+#include "memory_policy.h"
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// Indexed d-ary min-heap over items 0 .. capacity-1 with true decrease-key.
+// Every item is in the heap at most once, so it never holds more than
+// capacity entries (the lazy std::priority_queue Prim can grow to O(E)). A
+// position array maps each item to its heap slot; keys are stored next to
+// the items so sifting only touches the heap array.
+//
+// Arity defaults to 4: a shallower tree than a binary heap, and the Arity
+// children of a node share one or two cache lines.
+template <class K, class Item, unsigned Arity = 4>
+class IndexedDaryHeap
+{
+  static_assert(Arity >= 2, "heap arity must be at least 2");
+
+public:
+  typedef std::pair<K, Item> Entry;
+
+private:
+  static constexpr Item NOT_IN_HEAP = std::numeric_limits<Item>::max();
+
+  PolicyVector<Entry> heap_;
+  PolicyVector<Item> pos_;
+
+  void place(size_t slot, const Entry &e)
+  {
+    heap_[slot] = e;
+    pos_[e.second] = (Item)slot;
+  }
+
+  void siftUp(size_t slot)
+  {
+    Entry e = heap_[slot];
+    while (slot > 0)
+    {
+      size_t parent = (slot - 1) / Arity;
+      if (!(e.first < heap_[parent].first))
+        break;
+      place(slot, heap_[parent]);
+      slot = parent;
+    }
+    place(slot, e);
+  }
+
+  void siftDown(size_t slot)
+  {
+    Entry e = heap_[slot];
+    size_t n = heap_.size();
+    while (true)
+    {
+      size_t first = slot * Arity + 1;
+      if (first >= n)
+        break;
+      size_t last = first + Arity < n ? first + Arity : n;
+      size_t best = first;
+      for (size_t c = first + 1; c < last; ++c)
+        if (heap_[c].first < heap_[best].first)
+          best = c;
+      if (!(heap_[best].first < e.first))
+        break;
+      place(slot, heap_[best]);
+      slot = best;
+    }
+    place(slot, e);
+  }
+
+public:
+  explicit IndexedDaryHeap(Item capacity) : pos_(capacity, NOT_IN_HEAP)
+  {
+  }
+
+  bool empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+  bool contains(Item item) const { return pos_[item] != NOT_IN_HEAP; }
+  K keyOf(Item item) const { return heap_[pos_[item]].first; }
+  const Entry &top() const { return heap_.front(); }
+
+  void push(Item item, K key)
+  {
+    heap_.push_back(Entry(key, item));
+    siftUp(heap_.size() - 1);
+  }
+
+  // key must not be larger than the item's current key
+  void decreaseKey(Item item, K key)
+  {
+    size_t slot = pos_[item];
+    heap_[slot].first = key;
+    siftUp(slot);
+  }
+
+  // Inserts item, or lowers its key if key is smaller. Returns true if the
+  // heap changed.
+  bool pushOrDecrease(Item item, K key)
+  {
+    if (!contains(item))
+    {
+      push(item, key);
+      return true;
+    }
+    if (key < keyOf(item))
+    {
+      decreaseKey(item, key);
+      return true;
+    }
+    return false;
+  }
+
+  Entry pop()
+  {
+    Entry min = heap_.front();
+    pos_[min.second] = NOT_IN_HEAP;
+    Entry last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty())
+    {
+      heap_[0] = last;
+      siftDown(0);
+    }
+    return min;
+  }
+};
+
+template <class K, class Item, unsigned Arity>
+constexpr Item IndexedDaryHeap<K, Item, Arity>::NOT_IN_HEAP;
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef KKT_H
+#define KKT_H
+#include "ThreadPool.h"
+#include "edge_list.h"
+#include "memory_policy.h"
+#include "union_find.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// Randomized linear-expected-time MST (Karger, Klein, Tarjan):
+//
+//   solve(E): if E is small, run Kruskal
+//             two Boruvka steps: every vertex takes its lightest edge, the
+//               chosen edges are contracted
+//             H = a random half of the remaining edges
+//             F = solve(H)
+//             drop the F-heavy edges: those heavier than every edge on the
+//               path between their endpoints in F (they close a cycle in
+//               which they are the heaviest edge, so no MST contains them)
+//             solve(what is left)
+//
+// Path maxima come from binary lifting over F: for every vertex, the
+// ancestor 2^k levels up and the heaviest edge on the way. The heavy-edge
+// filter runs one query per edge, split into nTasks blocks on the
+// ThreadPool, as do the compaction passes. Edges are ordered by weight and
+// then by input position, so all keys are distinct and the forest is the
+// same for every sample.
+template <class V, class W>
+class KargerKleinTarjan
+{
+public:
+  typedef WeightedEdge<V, W> Edge;
+
+private:
+#pragma pack(push, 1)
+  struct Arc
+  {
+    V u;
+    V v;
+    W weight;
+    uint64_t id; // position in the input edge list
+  };
+#pragma pack(pop)
+
+  static const size_t BASE_CASE = 1 << 12; // Kruskal below this many edges
+  static const int BORUVKA_STEPS = 2;
+  static const size_t NONE = std::numeric_limits<size_t>::max();
+
+  ThreadPool &pool_;
+  size_t nTasks_;
+  uint64_t heavyEdges_ = 0;
+  unsigned maxLevel_ = 0;
+
+  static bool lighter(const Arc &a, const Arc &b)
+  {
+    return a.weight < b.weight || (a.weight == b.weight && a.id < b.id);
+  }
+
+  static bool sampled(uint64_t id, unsigned level)
+  {
+    uint64_t x = id + 0x9e3779b97f4a7c15ULL * (level + 1);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return ((x ^ (x >> 31)) & 1) != 0;
+  }
+
+  // Positions i in [0, n) with keep(i), in order: count per block, prefix
+  // sum, fill
+  template <class Keep>
+  std::vector<size_t> survivors(size_t n, Keep keep)
+  {
+    std::vector<size_t> start(nTasks_ + 1, 0);
+    poolFor(pool_, nTasks_, n, [&](size_t begin, size_t end, size_t t) {
+      size_t count = 0;
+      for (size_t i = begin; i < end; ++i)
+        count += keep(i);
+      start[t + 1] = count;
+    });
+    for (size_t t = 0; t < nTasks_; ++t)
+      start[t + 1] += start[t];
+    std::vector<size_t> kept(start[nTasks_]);
+    poolFor(pool_, nTasks_, n, [&](size_t begin, size_t end, size_t t) {
+      size_t out = start[t];
+      for (size_t i = begin; i < end; ++i)
+        if (keep(i))
+          kept[out++] = i;
+    });
+    return kept;
+  }
+
+  std::vector<size_t> kruskal(const std::vector<Arc> &arcs, V n)
+  {
+    std::vector<size_t> order(arcs.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return lighter(arcs[a], arcs[b]); });
+    DisjointSets<V> sets(n);
+    std::vector<size_t> chosen;
+    for (size_t i : order)
+      if (sets.unite(arcs[i].u, arcs[i].v))
+        chosen.push_back(i);
+    return chosen;
+  }
+
+  // One Boruvka step on arcs over n vertices: appends the lightest arc of
+  // every vertex to chosen and returns the arcs between different
+  // components, renumbered so that only components with arcs are vertices
+  // (nOut of them). origin[i] is the position in arcs of returned arc i.
+  std::vector<Arc> boruvkaStep(const std::vector<Arc> &arcs, V n, V &nOut, std::vector<size_t> &chosen,
+                               std::vector<size_t> &origin)
+  {
+    std::vector<size_t> best(n, NONE);
+    for (size_t i = 0; i < arcs.size(); ++i)
+    {
+      if (best[arcs[i].u] == NONE || lighter(arcs[i], arcs[best[arcs[i].u]]))
+        best[arcs[i].u] = i;
+      if (best[arcs[i].v] == NONE || lighter(arcs[i], arcs[best[arcs[i].v]]))
+        best[arcs[i].v] = i;
+    }
+    DisjointSets<V> sets(n);
+    for (V x = 0; x < n; ++x)
+      if (best[x] != NONE && sets.unite(arcs[best[x]].u, arcs[best[x]].v))
+        chosen.push_back(best[x]);
+
+    PolicyVector<V> root(n);
+    poolFor(pool_, nTasks_, n, [&](size_t begin, size_t end, size_t) {
+      for (size_t x = begin; x < end; ++x)
+        root[x] = sets.findRoot((V)x);
+    });
+    origin = survivors(arcs.size(), [&](size_t i) { return root[arcs[i].u] != root[arcs[i].v]; });
+
+    const V UNUSED = std::numeric_limits<V>::max();
+    std::vector<V> label(n, UNUSED);
+    nOut = 0;
+    for (size_t i : origin)
+    {
+      if (label[root[arcs[i].u]] == UNUSED)
+        label[root[arcs[i].u]] = nOut++;
+      if (label[root[arcs[i].v]] == UNUSED)
+        label[root[arcs[i].v]] = nOut++;
+    }
+    std::vector<Arc> out(origin.size());
+    poolFor(pool_, nTasks_, origin.size(), [&](size_t begin, size_t end, size_t) {
+      for (size_t k = begin; k < end; ++k)
+      {
+        const Arc &a = arcs[origin[k]];
+        out[k] = Arc{label[root[a.u]], label[root[a.v]], a.weight, a.id};
+      }
+    });
+    return out;
+  }
+
+  // Path-maximum queries over a forest given as arcs over n vertices
+  class PathMax
+  {
+  private:
+    const std::vector<Arc> &arcs_;
+    V n_;
+    unsigned levels_;
+    PolicyVector<V> tree_;   // root of the tree of every vertex
+    PolicyVector<V> depth_;
+    PolicyVector<V> up_;     // up_[k * n + v]: ancestor 2^k levels above v
+    PolicyVector<size_t> max_; // heaviest arc on the way there
+
+    size_t heavier(size_t a, size_t b) const
+    {
+      if (a == NONE)
+        return b;
+      if (b == NONE)
+        return a;
+      return lighter(arcs_[a], arcs_[b]) ? b : a;
+    }
+
+  public:
+    PathMax(const std::vector<Arc> &arcs, const std::vector<size_t> &forest, V n, ThreadPool &pool,
+            size_t nTasks)
+        : arcs_(arcs), n_(n), levels_(1), tree_(n), depth_(n, 0)
+    {
+      while ((uint64_t(1) << levels_) < n)
+        ++levels_;
+      up_.resize(size_t(levels_) * n);
+      max_.resize(size_t(levels_) * n);
+
+      // Root every tree by breadth-first search
+      std::vector<uint64_t> offsets(uint64_t(n) + 1, 0);
+      for (size_t f : forest)
+      {
+        offsets[arcs[f].u + 1]++;
+        offsets[arcs[f].v + 1]++;
+      }
+      for (V x = 0; x < n; ++x)
+        offsets[x + 1] += offsets[x];
+      std::vector<size_t> incident(offsets[n]);
+      std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+      for (size_t f : forest)
+      {
+        incident[fill[arcs[f].u]++] = f;
+        incident[fill[arcs[f].v]++] = f;
+      }
+      const V UNSEEN = std::numeric_limits<V>::max();
+      std::fill(tree_.begin(), tree_.end(), UNSEEN);
+      std::vector<V> queue;
+      for (V r = 0; r < n; ++r)
+      {
+        if (tree_[r] != UNSEEN)
+          continue;
+        tree_[r] = r;
+        up_[r] = r;
+        max_[r] = NONE;
+        queue.assign(1, r);
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+          V x = queue[head];
+          for (uint64_t i = offsets[x]; i < offsets[x + 1]; ++i)
+          {
+            const Arc &a = arcs[incident[i]];
+            V y = a.u == x ? a.v : a.u;
+            if (tree_[y] != UNSEEN)
+              continue;
+            tree_[y] = r;
+            depth_[y] = depth_[x] + 1;
+            up_[y] = x;
+            max_[y] = incident[i];
+            queue.push_back(y);
+          }
+        }
+      }
+
+      for (unsigned k = 1; k < levels_; ++k)
+      {
+        const V *upPrev = up_.data() + size_t(k - 1) * n;
+        const size_t *maxPrev = max_.data() + size_t(k - 1) * n;
+        V *up = up_.data() + size_t(k) * n;
+        size_t *mx = max_.data() + size_t(k) * n;
+        poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t) {
+          for (size_t x = begin; x < end; ++x)
+          {
+            up[x] = upPrev[upPrev[x]];
+            mx[x] = heavier(maxPrev[x], maxPrev[upPrev[x]]);
+          }
+        });
+      }
+    }
+
+    // True if a is heavier than every arc on the forest path between its
+    // endpoints (false if they are in different trees)
+    bool heavy(const Arc &a) const
+    {
+      V x = a.u, y = a.v;
+      if (tree_[x] != tree_[y])
+        return false;
+      if (depth_[x] < depth_[y])
+        std::swap(x, y);
+      size_t worst = NONE;
+      V diff = depth_[x] - depth_[y];
+      for (unsigned k = 0; diff; ++k, diff >>= 1)
+        if (diff & 1)
+        {
+          worst = heavier(worst, max_[size_t(k) * n_ + x]);
+          x = up_[size_t(k) * n_ + x];
+        }
+      if (x != y)
+      {
+        for (unsigned k = levels_; k-- > 0;)
+          if (up_[size_t(k) * n_ + x] != up_[size_t(k) * n_ + y])
+          {
+            worst = heavier(worst, heavier(max_[size_t(k) * n_ + x], max_[size_t(k) * n_ + y]));
+            x = up_[size_t(k) * n_ + x];
+            y = up_[size_t(k) * n_ + y];
+          }
+        worst = heavier(worst, heavier(max_[x], max_[y]));
+      }
+      return worst != NONE && lighter(arcs_[worst], a);
+    }
+  };
+
+  // Positions (in arcs) of the minimum spanning forest of arcs over n vertices
+  std::vector<size_t> solve(const std::vector<Arc> &arcs, V n, unsigned level)
+  {
+    maxLevel_ = std::max(maxLevel_, level + 1);
+    if (arcs.size() <= BASE_CASE)
+      return kruskal(arcs, n);
+
+    std::vector<size_t> chosen, origin;
+    V m = n;
+    std::vector<Arc> current = boruvkaStep(arcs, n, m, chosen, origin);
+    for (int step = 1; step < BORUVKA_STEPS && !current.empty(); ++step)
+    {
+      std::vector<size_t> stepChosen, stepOrigin;
+      V next = m;
+      std::vector<Arc> contracted = boruvkaStep(current, m, next, stepChosen, stepOrigin);
+      for (size_t p : stepChosen)
+        chosen.push_back(origin[p]);
+      for (size_t &p : stepOrigin)
+        p = origin[p];
+      origin.swap(stepOrigin);
+      current.swap(contracted);
+      m = next;
+    }
+    if (current.empty())
+      return chosen;
+
+    // Forest of a random half
+    std::vector<size_t> picked = survivors(current.size(), [&](size_t i) { return sampled(current[i].id, level); });
+    std::vector<Arc> sample(picked.size());
+    for (size_t k = 0; k < picked.size(); ++k)
+      sample[k] = current[picked[k]];
+    std::vector<size_t> forest = solve(sample, m, level + 1);
+
+    // Drop the edges that are heavy with respect to it
+    std::vector<size_t> light;
+    {
+      PathMax paths(sample, forest, m, pool_, nTasks_);
+      light = survivors(current.size(), [&](size_t i) { return !paths.heavy(current[i]); });
+    }
+    heavyEdges_ += current.size() - light.size();
+    std::vector<Arc> rest(light.size());
+    for (size_t k = 0; k < light.size(); ++k)
+      rest[k] = current[light[k]];
+    std::vector<Arc>().swap(current);
+    std::vector<Arc>().swap(sample);
+    for (size_t p : solve(rest, m, level + 1))
+      chosen.push_back(origin[light[p]]);
+    return chosen;
+  }
+
+public:
+  KargerKleinTarjan(ThreadPool &pool, size_t nTasks) : pool_(pool), nTasks_(nTasks < 1 ? 1 : nTasks) {}
+
+  // Minimum spanning forest of edges over numVertices vertices
+  std::vector<Edge> run(const PolicyVector<Edge> &edges, V numVertices)
+  {
+    std::vector<Arc> arcs(edges.size());
+    poolFor(pool_, nTasks_, edges.size(), [&](size_t begin, size_t end, size_t) {
+      for (size_t i = begin; i < end; ++i)
+        arcs[i] = Arc{edges[i].src, edges[i].dest, edges[i].weight, i};
+    });
+    std::vector<Edge> forest;
+    for (size_t p : solve(arcs, numVertices, 0))
+      forest.push_back(edges[p]);
+    return forest;
+  }
+
+  uint64_t heavyEdges() const { return heavyEdges_; }
+  unsigned recursionDepth() const { return maxLevel_; }
+};
+
+template <class V, class W>
+const size_t KargerKleinTarjan<V, W>::NONE;
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef KRUSKAL_H
+#define KRUSKAL_H
+#include "edge_list.h"
+#include "memory_policy.h"
+#include "quick_sort.h"
+#include "radix_sort.h"
+#include "union_find.h"
+#include <vector>
+
+// Sorts edges (any struct with a weight member) by weight with nThreads
+// threads: radix sort for integer weights, sample sort (quick_sort.h) on
+// the caller's pool otherwise. Returns true if the radix sort was used.
+template <class EdgeT>
+bool sortEdgesByWeight(EdgeT *edges, size_t n, ThreadPool &pool, uintE nThreads)
+{
+  if (radixSortEdgesByWeight(edges, n, nThreads))
+    return true;
+  sampleSort(edges, n, [](const EdgeT &a, const EdgeT &b) { return a.weight < b.weight; }, pool, nThreads);
+  return false;
+}
+
+// Kruskal scan over edges sorted by weight; stops once the forest spans
+// numVertices
+template <class V, class W>
+std::vector<WeightedEdge<V, W>> kruskalForest(const PolicyVector<WeightedEdge<V, W>> &sorted, V numVertices)
+{
+  DisjointSets<V> sets(numVertices);
+  std::vector<WeightedEdge<V, W>> forest;
+  uint64_t treeEdges = numVertices > 0 ? numVertices - 1 : 0;
+  for (size_t i = 0; i < sorted.size() && forest.size() < treeEdges; ++i)
+    if (sets.unite(sorted[i].src, sorted[i].dest))
+      forest.push_back(sorted[i]);
+  return forest;
+}
+
+#endif
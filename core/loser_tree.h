@@ -0,0 +1,87 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Tournament (loser) tree merging k sorted runs. Every internal node keeps
+// the run that lost the match played there and slot 0 keeps the overall
+// winner, so taking the smallest head and refilling from its run replays
+// only the log2(k) matches on that run's path, one comparison each. An
+// exhausted run loses every match; no sentinel value is needed, so any
+// element value (including the largest weight) merges correctly. Ties go to
+// the run with the lower index, which keeps the merge stable.
+template <class T, class Less = std::less<T>>
+class LoserTree
+{
+private:
+  std::vector<const T *> head_;
+  std::vector<const T *> end_;
+  std::vector<size_t> node_; // node_[0]: winner, node_[i]: loser at node i
+  size_t leaves_;
+  Less less_;
+
+  bool exhausted(size_t run) const { return head_[run] == end_[run]; }
+
+  // True if run a wins against run b
+  bool beats(size_t a, size_t b) const
+  {
+    if (exhausted(a))
+      return false;
+    if (exhausted(b))
+      return true;
+    if (less_(*head_[a], *head_[b]))
+      return true;
+    return !less_(*head_[b], *head_[a]) && a < b;
+  }
+
+public:
+  // runs[i] = [first, last) of run i, each sorted by less
+  explicit LoserTree(const std::vector<std::pair<const T *, const T *>> &runs, Less less = Less())
+      : leaves_(1), less_(less)
+  {
+    while (leaves_ < runs.size())
+      leaves_ <<= 1;
+    head_.assign(leaves_, nullptr);
+    end_.assign(leaves_, nullptr);
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+      head_[i] = runs[i].first;
+      end_[i] = runs[i].second;
+    }
+
+    std::vector<size_t> winner(2 * leaves_);
+    for (size_t i = 0; i < leaves_; ++i)
+      winner[leaves_ + i] = i;
+    node_.assign(leaves_, 0);
+    for (size_t n = leaves_ - 1; n >= 1; --n)
+    {
+      size_t a = winner[2 * n], b = winner[2 * n + 1];
+      bool aWins = beats(a, b);
+      winner[n] = aWins ? a : b;
+      node_[n] = aWins ? b : a;
+    }
+    node_[0] = winner[1];
+  }
+
+  bool empty() const { return exhausted(node_[0]); }
+
+  // Smallest remaining element; only valid if !empty()
+  const T &top() const { return *head_[node_[0]]; }
+
+  // Index of the run top() comes from
+  size_t topRun() const { return node_[0]; }
+
+  void pop()
+  {
+    size_t w = node_[0];
+    ++head_[w];
+    for (size_t n = (leaves_ + w) / 2; n >= 1; n /= 2)
+      if (beats(node_[n], w))
+        std::swap(node_[n], w);
+    node_[0] = w;
+  }
+};
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef MEMORY_POLICY_H
+#define MEMORY_POLICY_H
+#include "utils.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+// Page-size and NUMA placement policy for the large arrays (CSR offsets and
+// adjacency, compressed rows, MST working arrays). Arrays of at least
+// POLICY_MIN_BYTES allocated through PolicyAllocator are mmap'd directly so
+// the policy can be applied before any page is touched:
+//
+//   huge pages : none     - regular pages
+//                thp      - madvise(MADV_HUGEPAGE), transparent huge pages
+//                explicit - MAP_HUGETLB from the reserved pool, falling back
+//                           to thp when the pool is empty
+//   placement  : default    - kernel default (pages land on the node of the
+//                             thread that touches them first)
+//                firsttouch - threads pinned by runOnThreads() fault the
+//                             array in in nThreads contiguous blocks, so block
+//                             t lives on the node of runOnThreads() worker t.
+//                             That matches the later access pattern only for
+//                             runOnThreads() passes (parser, builder, radix
+//                             sort, reordering); ThreadPool workers are not
+//                             pinned, so the pool engines see the blocks
+//                             spread across nodes, much as with interleave
+//                interleave - mbind(MPOL_INTERLEAVE) across all online nodes
+//
+// Smaller arrays, and every array under the default policy, use operator new.
+// Binary graph files stay in the page cache mapping (graph_binary.h) and are
+// not affected.
+
+enum class HugePageMode { None, Transparent, Explicit };
+enum class NumaPlacement { Default, FirstTouch, Interleave };
+
+struct MemoryPolicy
+{
+  HugePageMode hugePages = HugePageMode::None;
+  NumaPlacement placement = NumaPlacement::Default;
+  uintE touchThreads = 1; // threads that fault pages in under FirstTouch
+
+  bool isDefault() const
+  {
+    return hugePages == HugePageMode::None && placement == NumaPlacement::Default;
+  }
+};
+
+struct MemoryPolicyStats
+{
+  std::atomic<uint64_t> arrays{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> hugetlbBytes{0};
+  std::atomic<uint64_t> fallbacks{0};
+};
+
+static const size_t POLICY_MIN_BYTES = size_t(1) << 21;
+static const size_t HUGE_PAGE_BYTES = size_t(1) << 21;
+static const size_t BASE_PAGE_BYTES = 4096;
+
+inline MemoryPolicy &memoryPolicy()
+{
+  static MemoryPolicy policy;
+  return policy;
+}
+
+inline MemoryPolicyStats &memoryPolicyStats()
+{
+  static MemoryPolicyStats stats;
+  return stats;
+}
+
+inline HugePageMode hugePageModeFromName(const std::string &name)
+{
+  if (name == "none") return HugePageMode::None;
+  if (name == "thp") return HugePageMode::Transparent;
+  if (name == "explicit") return HugePageMode::Explicit;
+  throw std::invalid_argument("Unknown huge page mode: " + name);
+}
+
+inline const char *hugePageModeName(HugePageMode mode)
+{
+  switch (mode)
+  {
+  case HugePageMode::Transparent: return "thp";
+  case HugePageMode::Explicit: return "explicit";
+  default: return "none";
+  }
+}
+
+inline NumaPlacement numaPlacementFromName(const std::string &name)
+{
+  if (name == "default") return NumaPlacement::Default;
+  if (name == "firsttouch") return NumaPlacement::FirstTouch;
+  if (name == "interleave") return NumaPlacement::Interleave;
+  throw std::invalid_argument("Unknown NUMA placement: " + name);
+}
+
+inline const char *numaPlacementName(NumaPlacement placement)
+{
+  switch (placement)
+  {
+  case NumaPlacement::FirstTouch: return "firsttouch";
+  case NumaPlacement::Interleave: return "interleave";
+  default: return "default";
+  }
+}
+
+// Online NUMA node ids, parsed from a sysfs list such as "0-1,3"
+inline std::vector<int> onlineNumaNodes()
+{
+  std::vector<int> nodes;
+  std::ifstream in("/sys/devices/system/node/online");
+  std::string list;
+  if (in >> list)
+  {
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ','))
+    {
+      size_t dash = range.find('-');
+      int lo = std::atoi(range.c_str());
+      int hi = dash == std::string::npos ? lo : std::atoi(range.c_str() + dash + 1);
+      for (int node = lo; node <= hi; ++node)
+        nodes.push_back(node);
+    }
+  }
+  if (nodes.empty())
+    nodes.push_back(0);
+  return nodes;
+}
+
+// mbind(MPOL_INTERLEAVE) over all online nodes; glibc has no wrapper and
+// libnuma is not assumed to be installed
+inline bool interleavePages(void *p, size_t length)
+{
+  const int MPOL_INTERLEAVE_MODE = 3;
+  const unsigned long MASK_BITS = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> mask(1);
+  for (int node : onlineNumaNodes())
+  {
+    if (size_t(node) / MASK_BITS >= mask.size())
+      mask.resize(node / MASK_BITS + 1, 0);
+    mask[node / MASK_BITS] |= 1UL << (node % MASK_BITS);
+  }
+  return ::syscall(SYS_mbind, p, length, MPOL_INTERLEAVE_MODE, mask.data(),
+                   mask.size() * MASK_BITS + 1, 0) == 0;
+}
+
+// Faults [p, p + length) in with nThreads threads, one contiguous block each
+inline void firstTouchPages(void *p, size_t length, uintE nThreads)
+{
+  if (nThreads < 1)
+    nThreads = 1;
+  volatile char *bytes = static_cast<char *>(p);
+  size_t pages = length / BASE_PAGE_BYTES;
+  runOnThreads(nThreads, [&](uintE t) {
+    for (size_t page = pages * t / nThreads; page < pages * (t + 1) / nThreads; ++page)
+      bytes[page * BASE_PAGE_BYTES] = 0;
+  });
+}
+
+// Mappings made by policyAllocate(), so that policyDeallocate() does not
+// depend on the policy (or threshold) in effect when the array is freed
+inline std::map<void *, size_t> &policyMappings()
+{
+  static std::map<void *, size_t> mappings;
+  return mappings;
+}
+
+inline std::mutex &policyMappingsMutex()
+{
+  static std::mutex m;
+  return m;
+}
+
+inline void *policyAllocate(size_t bytes)
+{
+  const MemoryPolicy &policy = memoryPolicy();
+  if (bytes < POLICY_MIN_BYTES || policy.isDefault())
+    return ::operator new(bytes);
+
+  MemoryPolicyStats &stats = memoryPolicyStats();
+  size_t length = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+  void *p = MAP_FAILED;
+  if (policy.hugePages == HugePageMode::Explicit)
+  {
+    p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+      stats.hugetlbBytes += length;
+    else
+      stats.fallbacks++;
+  }
+  if (p == MAP_FAILED)
+  {
+    p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      throw std::bad_alloc();
+    if (policy.hugePages != HugePageMode::None)
+      ::madvise(p, length, MADV_HUGEPAGE);
+  }
+  if (policy.placement == NumaPlacement::Interleave && !interleavePages(p, length))
+    stats.fallbacks++;
+  if (policy.placement == NumaPlacement::FirstTouch)
+    firstTouchPages(p, length, policy.touchThreads);
+
+  {
+    std::lock_guard<std::mutex> lock(policyMappingsMutex());
+    policyMappings()[p] = length;
+  }
+  stats.arrays++;
+  stats.bytes += length;
+  return p;
+}
+
+inline void policyDeallocate(void *p)
+{
+  size_t length = 0;
+  {
+    std::lock_guard<std::mutex> lock(policyMappingsMutex());
+    auto it = policyMappings().find(p);
+    if (it != policyMappings().end())
+    {
+      length = it->second;
+      policyMappings().erase(it);
+    }
+  }
+  if (length > 0)
+    ::munmap(p, length);
+  else
+    ::operator delete(p);
+}
+
+// Standard allocator that routes through policyAllocate()
+template <class T>
+struct PolicyAllocator
+{
+  typedef T value_type;
+
+  PolicyAllocator() = default;
+  template <class U>
+  PolicyAllocator(const PolicyAllocator<U> &) {}
+
+  T *allocate(size_t n)
+  {
+    return static_cast<T *>(policyAllocate(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t)
+  {
+    policyDeallocate(p);
+  }
+};
+
+template <class T, class U>
+bool operator==(const PolicyAllocator<T> &, const PolicyAllocator<U> &) { return true; }
+template <class T, class U>
+bool operator!=(const PolicyAllocator<T> &, const PolicyAllocator<U> &) { return false; }
+
+template <class T>
+using PolicyVector = std::vector<T, PolicyAllocator<T>>;
+
+// Transparent huge pages currently backing this process, in kB
+inline long anonHugePagesKb()
+{
+  std::ifstream in("/proc/self/smaps_rollup");
+  std::string key;
+  long value;
+  while (in >> key)
+  {
+    if (key == "AnonHugePages:" && in >> value)
+      return value;
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return -1;
+}
+
+// Sets the process-wide policy from the --hugePages / --numa flags and
+// prints it. firsttouch also pins runOnThreads() workers to CPUs.
+inline void configureMemoryPolicy(const std::string &hugePages, const std::string &placement, uintE nThreads)
+{
+  MemoryPolicy &policy = memoryPolicy();
+  policy.hugePages = hugePageModeFromName(hugePages);
+  policy.placement = numaPlacementFromName(placement);
+  policy.touchThreads = nThreads < 1 ? 1 : nThreads;
+  pinThreads() = policy.placement == NumaPlacement::FirstTouch;
+  std::cout << "Memory policy : huge pages=" << hugePageModeName(policy.hugePages)
+            << ", placement=" << numaPlacementName(policy.placement)
+            << ", NUMA nodes=" << onlineNumaNodes().size()
+            << ", pinned threads=" << (pinThreads() ? "yes" : "no") << std::endl;
+}
+
+// Reports what the policy actually achieved
+inline void printMemoryPolicyUsage()
+{
+  if (memoryPolicy().isDefault())
+    return;
+  const MemoryPolicyStats &stats = memoryPolicyStats();
+  std::cout << "Policy arrays : " << stats.arrays << " (" << stats.bytes << " bytes), explicit huge pages: "
+            << stats.hugetlbBytes << " bytes, fallbacks: " << stats.fallbacks;
+  long thp = anonHugePagesKb();
+  if (thp >= 0)
+    std::cout << ", AnonHugePages: " << thp << " kB";
+  std::cout << std::endl;
+}
+
+#endif
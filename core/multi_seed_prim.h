@@ -0,0 +1,269 @@
+#ifndef MULTI_SEED_PRIM_H
+#define MULTI_SEED_PRIM_H
+#include "ThreadPool.h"
+#include "edge_list.h"
+#include "graph_types.h"
+#include "memory_policy.h"
+#include "union_find.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <functional>
+#include <vector>
+
+// Multi-seed parallel Prim (Bader and Cong). Each worker repeatedly picks an
+// unclaimed seed vertex from its block and grows a Prim tree from it with a
+// private heap, claiming vertices by compare-and-swap on a shared colour
+// array. A tree stops growing as soon as its lightest frontier edge leads to
+// a vertex claimed by another tree. Edges are ordered by weight and then by
+// their input endpoints, so all weights are distinct and the lightest edge
+// leaving a tree always belongs to the MST: that includes the edge a tree
+// collided on, which hooks the two trees together in a
+// ConcurrentDisjointSets (when both trees collide on the same edge only one
+// unite succeeds). Once every vertex is claimed the hooked trees are
+// contracted into single vertices, keeping the lightest edge between each
+// pair, and the next round runs on the contracted graph until no edges are
+// left. Every tree with an outgoing edge hooks, so each round at least
+// halves the number of trees.
+
+// Contracted graph in CSR form; each entry remembers the input edge it came
+// from so the forest can be reported with input vertex ids
+template <class V, class W>
+struct ContractedGraph
+{
+#pragma pack(push, 1)
+  struct Entry
+  {
+    V vertex;
+    W weight;
+    V srcIn;
+    V destIn;
+  };
+#pragma pack(pop)
+
+  V numVertices_ = 0;
+  PolicyVector<uint64_t> offsets;
+  PolicyVector<Entry> adjacency;
+
+  V numVertices() const { return numVertices_; }
+  uint64_t numEdges() const { return offsets.empty() ? 0 : offsets[numVertices_]; }
+
+  // f(neighbor, weight, input src, input dest)
+  template <class F>
+  void forEachEdge(V u, F &&f) const
+  {
+    for (uint64_t i = offsets[u]; i < offsets[u + 1]; ++i)
+      f(adjacency[i].vertex, adjacency[i].weight, adjacency[i].srcIn, adjacency[i].destIn);
+  }
+};
+
+// The input graph seen through the same interface as ContractedGraph
+template <class GraphT>
+struct InputGraphEdges
+{
+  typedef typename GraphT::VertexType V;
+  typedef typename GraphT::WeightType W;
+  const GraphT &g;
+
+  V numVertices() const { return g.numVertices(); }
+
+  template <class F>
+  void forEachEdge(V u, F &&f) const
+  {
+    g.forEachNeighbor(u, [&](V v, W w) { f(v, w, u, v); });
+  }
+};
+
+// One round: grows trees until every vertex is claimed. label[v] receives
+// the hooked group of trees (named by one of their seeds) that v belongs to;
+// forest edges are appended to forest.
+template <class V, class W, class EdgesT>
+void growTrees(const EdgesT &g, ThreadPool &pool, size_t nTasks, PolicyVector<V> &label,
+               std::vector<WeightedEdge<V, W>> &forest)
+{
+  struct Frontier
+  {
+    W weight;
+    V lo; // input endpoints, lo < hi
+    V hi;
+    V vertex;
+    bool operator>(const Frontier &o) const
+    {
+      if (weight != o.weight)
+        return weight > o.weight;
+      return lo != o.lo ? lo > o.lo : hi > o.hi;
+    }
+  };
+  const V UNCLAIMED = noVertex<V>();
+  V n = g.numVertices();
+  std::unique_ptr<std::atomic<V>[]> color(new std::atomic<V>[n]);
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t) {
+    for (size_t v = begin; v < end; ++v)
+      color[v].store(UNCLAIMED, std::memory_order_relaxed);
+  });
+
+  ConcurrentDisjointSets<V> trees(n);
+  std::vector<std::vector<WeightedEdge<V, W>>> grown(nTasks);
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t t) {
+    // Binary heap on a vector so its capacity is reused from seed to seed
+    std::vector<Frontier> heap;
+    auto push = [&](const Frontier &f) {
+      heap.push_back(f);
+      std::push_heap(heap.begin(), heap.end(), std::greater<Frontier>());
+    };
+    auto claim = [&](V v, V tree) {
+      V expected = UNCLAIMED;
+      return color[v].compare_exchange_strong(expected, tree, std::memory_order_acq_rel);
+    };
+    auto expand = [&](V u, V tree) {
+      g.forEachEdge(u, [&](V v, W w, V srcIn, V destIn) {
+        if (color[v].load(std::memory_order_relaxed) != tree)
+          push(srcIn < destIn ? Frontier{w, srcIn, destIn, v} : Frontier{w, destIn, srcIn, v});
+      });
+    };
+
+    for (size_t s = begin; s < end; ++s)
+    {
+      V seed = (V)s;
+      if (!claim(seed, seed))
+        continue;
+      heap.clear();
+      expand(seed, seed);
+      while (!heap.empty())
+      {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Frontier>());
+        Frontier f = heap.back();
+        heap.pop_back();
+        V c = color[f.vertex].load(std::memory_order_acquire);
+        if (c == seed)
+          continue; // reached the tree by a lighter edge earlier
+        if (c == UNCLAIMED && claim(f.vertex, seed))
+        {
+          grown[t].push_back(WeightedEdge<V, W>{f.lo, f.hi, f.weight});
+          expand(f.vertex, seed);
+          continue;
+        }
+        // Collided with another tree: hook onto it along this edge and stop
+        c = color[f.vertex].load(std::memory_order_acquire);
+        if (trees.unite(seed, c))
+          grown[t].push_back(WeightedEdge<V, W>{f.lo, f.hi, f.weight});
+        break;
+      }
+    }
+  });
+
+  label.resize(n);
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t) {
+    for (size_t v = begin; v < end; ++v)
+      label[v] = trees.find(color[v].load(std::memory_order_relaxed));
+  });
+  for (const auto &edges : grown)
+    forest.insert(forest.end(), edges.begin(), edges.end());
+}
+
+// Contracts every tree of label into one vertex. Edges inside a tree are
+// dropped and of several edges between two trees only the lightest is kept.
+template <class V, class W, class EdgesT>
+ContractedGraph<V, W> contractTrees(const EdgesT &g, const PolicyVector<V> &label, ThreadPool &pool,
+                                    size_t nTasks)
+{
+  typedef typename ContractedGraph<V, W>::Entry Entry;
+  V n = g.numVertices();
+
+  // Groups are named by one of their seeds, which is labelled with itself
+  PolicyVector<V> newId(n);
+  V numTrees = 0;
+  for (V v = 0; v < n; ++v)
+    if (label[v] == v)
+      newId[v] = numTrees++;
+
+  ContractedGraph<V, W> out;
+  out.numVertices_ = numTrees;
+  std::unique_ptr<std::atomic<uint64_t>[]> cursor(new std::atomic<uint64_t>[numTrees + 1]());
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t) {
+    for (size_t u = begin; u < end; ++u)
+      g.forEachEdge((V)u, [&](V v, W, V, V) {
+        if (label[u] != label[v])
+          cursor[newId[label[u]]].fetch_add(1, std::memory_order_relaxed);
+      });
+  });
+  PolicyVector<uint64_t> offsets(uint64_t(numTrees) + 1, 0);
+  for (V c = 0; c < numTrees; ++c)
+  {
+    offsets[c + 1] = offsets[c] + cursor[c].load(std::memory_order_relaxed);
+    cursor[c].store(offsets[c], std::memory_order_relaxed);
+  }
+  PolicyVector<Entry> adjacency(offsets[numTrees]);
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t) {
+    for (size_t u = begin; u < end; ++u)
+      g.forEachEdge((V)u, [&](V v, W w, V srcIn, V destIn) {
+        if (label[u] != label[v])
+          adjacency[cursor[newId[label[u]]].fetch_add(1, std::memory_order_relaxed)] =
+              Entry{newId[label[v]], w, srcIn, destIn};
+      });
+  });
+
+  // Keep the lightest entry per neighbouring tree, compacting each row.
+  // Lightest is in the (weight, lo, hi) order growTrees uses, so both rows
+  // of a tree pair keep the same input edge even among equal weights.
+  PolicyVector<uint64_t> kept(uint64_t(numTrees) + 1, 0);
+  poolFor(pool, nTasks, numTrees, [&](size_t begin, size_t end, size_t) {
+    for (size_t c = begin; c < end; ++c)
+    {
+      Entry *row = adjacency.data() + offsets[c];
+      Entry *rowEnd = adjacency.data() + offsets[c + 1];
+      std::sort(row, rowEnd, [](const Entry &a, const Entry &b) {
+        if (a.vertex != b.vertex)
+          return a.vertex < b.vertex;
+        if (a.weight != b.weight)
+          return a.weight < b.weight;
+        V aLo = std::min(a.srcIn, a.destIn), bLo = std::min(b.srcIn, b.destIn);
+        if (aLo != bLo)
+          return aLo < bLo;
+        return std::max(a.srcIn, a.destIn) < std::max(b.srcIn, b.destIn);
+      });
+      Entry *last = row;
+      for (Entry *p = row; p < rowEnd; ++p)
+        if (p == row || p->vertex != (last - 1)->vertex)
+          *last++ = *p;
+      kept[c + 1] = last - row;
+    }
+  });
+  for (V c = 0; c < numTrees; ++c)
+  {
+    kept[c + 1] += kept[c];
+    std::copy(adjacency.begin() + offsets[c], adjacency.begin() + offsets[c] + (kept[c + 1] - kept[c]),
+              adjacency.begin() + kept[c]);
+  }
+  adjacency.resize(kept[numTrees]);
+  out.offsets = std::move(kept);
+  out.adjacency = std::move(adjacency);
+  return out;
+}
+
+// Minimum spanning forest of g with nTasks workers on pool. GraphT is Graph
+// or CompressedGraph.
+template <class GraphT>
+std::vector<WeightedEdge<typename GraphT::VertexType, typename GraphT::WeightType>>
+multiSeedPrimMSF(const GraphT &g, ThreadPool &pool, size_t nTasks)
+{
+  typedef typename GraphT::VertexType V;
+  typedef typename GraphT::WeightType W;
+  if (nTasks < 1)
+    nTasks = 1;
+  std::vector<WeightedEdge<V, W>> forest;
+  PolicyVector<V> label;
+
+  InputGraphEdges<GraphT> input{g};
+  growTrees<V, W>(input, pool, nTasks, label, forest);
+  ContractedGraph<V, W> current = contractTrees<V, W>(input, label, pool, nTasks);
+  while (current.numEdges() > 0)
+  {
+    growTrees<V, W>(current, pool, nTasks, label, forest);
+    current = contractTrees<V, W>(current, label, pool, nTasks);
+  }
+  return forest;
+}
+
+#endif
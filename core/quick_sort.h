@@ -22,8 +22,11 @@
 
 #ifndef A_QSORT_INCLUDED
 #define A_QSORT_INCLUDED
+#include "ThreadPool.h"
 #include <algorithm>
-// #include "parallel.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 template <class E, class BinPred, class intT>
 void insertionSort(E *A, intT n, BinPred f) {
@@ -44,7 +47,8 @@ template <class E, class BinPred> E median(E a, E b, E c, BinPred f) {
 }
 
 // Quicksort based on median of three elements as pivot
-//  and uses insertionSort for small inputs
+//  and uses insertionSort for small inputs. Sequential; sampleSort below
+//  sorts in parallel and uses it for the buckets.
 template <class E, class BinPred, class intT>
 void quickSort(E *A, intT n, BinPred f) {
   if (n < ISORT)
@@ -72,11 +76,100 @@ void quickSort(E *A, intT n, BinPred f) {
         std::swap(*M, *(L++));
       M++;
     }
-#pragma omp task
     quickSort(A, L - A, f);
     quickSort(M, A + n - M, f); // Exclude all elts that equal pivot
-#pragma omp taskwait
   }
 }
 
+#define SSORT_SEQUENTIAL (1 << 14) // quickSort below this size
+#define SSORT_OVERSAMPLE 16         // samples per splitter
+#define SSORT_BUCKETS_PER_TASK 4
+
+// Parallel sample sort on nTasks blocks of the pool:
+//  1. pick nBuckets-1 splitters from SSORT_OVERSAMPLE * nBuckets samples
+//  2. every block finds the bucket of each element (binary search over the
+//     splitters) and counts its bucket sizes
+//  3. a prefix sum over (bucket, block) places every block's share of every
+//     bucket; the blocks scatter their elements into a buffer
+//  4. the buckets are sorted with quickSort in parallel and copied back
+// Elements equal to a splitter all land in one bucket, so inputs with many
+//  duplicates stay correct (quickSort groups equal keys in one pass).
+template <class E, class BinPred, class intT>
+void sampleSort(E *A, intT n, BinPred f, ThreadPool &pool, size_t nTasks) {
+  if (nTasks < 1)
+    nTasks = 1;
+  if (n < SSORT_SEQUENTIAL || nTasks == 1) {
+    quickSort(A, n, f);
+    return;
+  }
+  size_t nBuckets = nTasks * SSORT_BUCKETS_PER_TASK;
+
+  // 1. Splitters from an evenly spread, hashed sample
+  size_t nSamples = nBuckets * SSORT_OVERSAMPLE;
+  std::vector<E> samples(nSamples);
+  for (size_t i = 0; i < nSamples; ++i) {
+    uint64_t h = (i + 1) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 31;
+    samples[i] = A[h % (uint64_t)n];
+  }
+  quickSort(samples.data(), nSamples, f);
+  std::vector<E> splitters(nBuckets - 1);
+  for (size_t b = 1; b < nBuckets; ++b)
+    splitters[b - 1] = samples[b * SSORT_OVERSAMPLE];
+
+  // 2. Bucket of every element, counted per block
+  std::vector<uint32_t> bucketOf(n);
+  std::vector<size_t> offset(nTasks * nBuckets, 0);
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t t) {
+    size_t *count = offset.data() + t * nBuckets;
+    for (size_t i = begin; i < end; ++i) {
+      uint32_t b = std::upper_bound(splitters.begin(), splitters.end(), A[i], f) - splitters.begin();
+      bucketOf[i] = b;
+      count[b]++;
+    }
+  });
+
+  // 3. Bucket-major prefix sum, then scatter
+  std::vector<size_t> bucketStart(nBuckets + 1, 0);
+  size_t sum = 0;
+  for (size_t b = 0; b < nBuckets; ++b) {
+    bucketStart[b] = sum;
+    for (size_t t = 0; t < nTasks; ++t) {
+      size_t c = offset[t * nBuckets + b];
+      offset[t * nBuckets + b] = sum;
+      sum += c;
+    }
+  }
+  bucketStart[nBuckets] = sum;
+  std::vector<E> buffer(n);
+  poolFor(pool, nTasks, n, [&](size_t begin, size_t end, size_t t) {
+    size_t *next = offset.data() + t * nBuckets;
+    for (size_t i = begin; i < end; ++i)
+      buffer[next[bucketOf[i]]++] = A[i];
+  });
+
+  // 4. Sort the buckets and copy them back
+  poolFor(pool, nTasks, nBuckets, [&](size_t begin, size_t end, size_t) {
+    for (size_t b = begin; b < end; ++b) {
+      E *bucket = buffer.data() + bucketStart[b];
+      size_t size = bucketStart[b + 1] - bucketStart[b];
+      quickSort(bucket, size, f);
+      std::copy(bucket, bucket + size, A + bucketStart[b]);
+    }
+  });
+}
+
+// Same interface as quickSort, with one pool thread per hardware thread.
+// Builds a pool per call; callers that sort repeatedly should pass their own.
+template <class E, class BinPred, class intT>
+void sampleSort(E *A, intT n, BinPred f) {
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+  if (n < SSORT_SEQUENTIAL || nThreads == 1) {
+    quickSort(A, n, f);
+    return;
+  }
+  ThreadPool pool(nThreads);
+  sampleSort(A, n, f, pool, nThreads);
+}
+
 #endif // _A_QSORT_INCLUDED
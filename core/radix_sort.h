@@ -0,0 +1,137 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+#include "memory_policy.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Inputs below this size are sorted by the calling thread alone
+const size_t RADIX_PARALLEL_MIN = 1 << 16;
+
+// Parallel LSD radix sort of 64-bit keys on bits [lowBit, lowBit + bits),
+// 8 bits per pass. Every pass, each of nThreads threads builds a histogram
+// of its block; a prefix sum over (digit, thread) gives every thread its
+// output position per digit, and the threads scatter their blocks. Passes
+// are stable, so keys that tie on the sorted bits keep their input order.
+// The threads run once for all passes and meet at a barrier between phases.
+inline void radixSortKeys(uint64_t *keys, size_t n, unsigned lowBit, unsigned bits, uintE nThreads)
+{
+  const unsigned DIGIT_BITS = 8;
+  const size_t BUCKETS = size_t(1) << DIGIT_BITS;
+  unsigned passes = (bits + DIGIT_BITS - 1) / DIGIT_BITS;
+  if (passes == 0 || n < 2)
+    return;
+  if (n < RADIX_PARALLEL_MIN || nThreads < 1)
+    nThreads = 1;
+
+  PolicyVector<uint64_t> scratch(n);
+  std::vector<size_t> count(size_t(nThreads) * BUCKETS);
+  CustomBarrier barrier(nThreads);
+  runOnThreads(nThreads, [&](uintE t) {
+    size_t begin = n * t / nThreads, end = n * (t + 1) / nThreads;
+    uint64_t *from = keys, *to = scratch.data();
+    for (unsigned pass = 0; pass < passes; ++pass)
+    {
+      unsigned shift = lowBit + pass * DIGIT_BITS;
+      size_t *mine = count.data() + size_t(t) * BUCKETS;
+      std::fill(mine, mine + BUCKETS, 0);
+      for (size_t i = begin; i < end; ++i)
+        mine[(from[i] >> shift) & (BUCKETS - 1)]++;
+      barrier.wait();
+
+      if (t == 0)
+      {
+        size_t sum = 0;
+        for (size_t d = 0; d < BUCKETS; ++d)
+          for (uintE u = 0; u < nThreads; ++u)
+          {
+            size_t c = count[size_t(u) * BUCKETS + d];
+            count[size_t(u) * BUCKETS + d] = sum;
+            sum += c;
+          }
+      }
+      barrier.wait();
+
+      for (size_t i = begin; i < end; ++i)
+        to[mine[(from[i] >> shift) & (BUCKETS - 1)]++] = from[i];
+      barrier.wait();
+      std::swap(from, to);
+    }
+    // An odd number of passes leaves the result in scratch
+    if (passes % 2)
+      std::copy(scratch.data() + begin, scratch.data() + end, keys + begin);
+  });
+}
+
+// Number of bits needed to represent x
+inline unsigned bitWidth(uint64_t x)
+{
+  unsigned bits = 0;
+  while (x >> bits)
+    ++bits;
+  return bits;
+}
+
+// Sorts edges (any struct with a weight member) by weight, ties in input
+// order, when the weights are integers: each edge becomes the key
+// (weight - min) << indexBits | index, the keys are radix sorted on their
+// weight bits only (they start in index order and the sort is stable) and
+// the edges are permuted along them. Returns false and leaves edges alone if
+// the weights are not integral or the keys do not fit in 64 bits.
+template <class EdgeT>
+bool radixSortEdgesByWeight(EdgeT *edges, size_t n, uintE nThreads)
+{
+  typedef typename std::decay<decltype(edges->weight)>::type W;
+  if (!std::is_integral<W>::value)
+    return false;
+  if (n < 2)
+    return true;
+  if (n < RADIX_PARALLEL_MIN || nThreads < 1)
+    nThreads = 1;
+
+  std::vector<int64_t> lo(nThreads, 0), hi(nThreads, 0);
+  runOnThreads(nThreads, [&](uintE t) {
+    size_t begin = n * t / nThreads, end = n * (t + 1) / nThreads;
+    if (begin == end)
+      return;
+    lo[t] = hi[t] = (int64_t)edges[begin].weight;
+    for (size_t i = begin; i < end; ++i)
+    {
+      lo[t] = std::min(lo[t], (int64_t)edges[i].weight);
+      hi[t] = std::max(hi[t], (int64_t)edges[i].weight);
+    }
+  });
+  int64_t minWeight = (int64_t)edges[0].weight, maxWeight = minWeight;
+  for (uintE t = 0; t < nThreads; ++t)
+    if (n * t / nThreads != n * (t + 1) / nThreads)
+    {
+      minWeight = std::min(minWeight, lo[t]);
+      maxWeight = std::max(maxWeight, hi[t]);
+    }
+  unsigned indexBits = bitWidth(n - 1);
+  unsigned weightBits = bitWidth(uint64_t(maxWeight - minWeight));
+  if (indexBits + weightBits > 64)
+    return false;
+
+  PolicyVector<uint64_t> keys(n);
+  runOnThreads(nThreads, [&](uintE t) {
+    for (size_t i = n * t / nThreads; i < n * (t + 1) / nThreads; ++i)
+      keys[i] = (uint64_t((int64_t)edges[i].weight - minWeight) << indexBits) | i;
+  });
+  radixSortKeys(keys.data(), n, indexBits, weightBits, nThreads);
+
+  const uint64_t indexMask = (uint64_t(1) << indexBits) - 1;
+  PolicyVector<EdgeT> sorted(n);
+  runOnThreads(nThreads, [&](uintE t) {
+    for (size_t i = n * t / nThreads; i < n * (t + 1) / nThreads; ++i)
+      sorted[i] = edges[keys[i] & indexMask];
+  });
+  runOnThreads(nThreads, [&](uintE t) {
+    std::copy(sorted.data() + n * t / nThreads, sorted.data() + n * (t + 1) / nThreads, edges + n * t / nThreads);
+  });
+  return true;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+#include "memory_policy.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+// Sequential disjoint sets with union by rank and iterative path halving
+// (no recursion, so long parent chains cannot overflow the stack)
+template <class V>
+class DisjointSets
+{
+private:
+  PolicyVector<V> parent_;
+  PolicyVector<uint8_t> rank_;
+
+public:
+  explicit DisjointSets(V size) : parent_(size), rank_(size, 0)
+  {
+    std::iota(parent_.begin(), parent_.end(), V(0));
+  }
+
+  V find(V u)
+  {
+    while (parent_[u] != u)
+    {
+      parent_[u] = parent_[parent_[u]];
+      u = parent_[u];
+    }
+    return u;
+  }
+
+  // Root of u without modifying the structure; safe to call from several
+  // threads as long as nobody unites concurrently
+  V findRoot(V u) const
+  {
+    while (parent_[u] != u)
+      u = parent_[u];
+    return u;
+  }
+
+  bool connected(V u, V v) const
+  {
+    return findRoot(u) == findRoot(v);
+  }
+
+  // Merges the sets of u and v; returns false if they were already one set
+  bool unite(V u, V v)
+  {
+    u = find(u);
+    v = find(v);
+    if (u == v)
+      return false;
+    if (rank_[u] < rank_[v])
+      std::swap(u, v);
+    parent_[v] = u;
+    if (rank_[u] == rank_[v])
+      rank_[u]++;
+    return true;
+  }
+};
+
+// Concurrent disjoint sets that any number of threads may use at once:
+//
+//   find  : lock-free; path halving, each step a compare-and-swap of
+//           parent[u] from p to its grandparent (losing the race is harmless,
+//           someone else shortened the path)
+//   unite : links one root under the other with a CAS on the root's parent,
+//           retrying from fresh roots if another thread linked it first
+//
+// Linking is randomized by a fixed hash of the vertex id (ties broken by id),
+// which gives a total order on roots, so links can never form a cycle, and
+// keeps trees shallow in expectation without a rank array.
+template <class V>
+class ConcurrentDisjointSets
+{
+private:
+  std::unique_ptr<std::atomic<V>[]> parent_;
+  V size_;
+
+  static uint64_t priority(V v)
+  {
+    uint64_t x = uint64_t(v) + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  // True if root a should be linked under root b
+  static bool linksUnder(V a, V b)
+  {
+    uint64_t pa = priority(a), pb = priority(b);
+    return pa < pb || (pa == pb && a < b);
+  }
+
+public:
+  explicit ConcurrentDisjointSets(V size) : parent_(new std::atomic<V>[size]), size_(size)
+  {
+    for (V v = 0; v < size; ++v)
+      parent_[v].store(v, std::memory_order_relaxed);
+  }
+
+  V size() const { return size_; }
+
+  V find(V u)
+  {
+    while (true)
+    {
+      V p = parent_[u].load(std::memory_order_acquire);
+      if (p == u)
+        return u;
+      V gp = parent_[p].load(std::memory_order_acquire);
+      if (gp == p)
+        return p;
+      parent_[u].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+      u = gp;
+    }
+  }
+
+  bool connected(V u, V v)
+  {
+    while (true)
+    {
+      u = find(u);
+      v = find(v);
+      if (u == v)
+        return true;
+      // u was a root when found; if it still is, the sets really differ
+      if (parent_[u].load(std::memory_order_acquire) == u)
+        return false;
+    }
+  }
+
+  // Merges the sets of u and v; returns false if they were already one set.
+  // Exactly one of several threads uniting the same two sets gets true.
+  bool unite(V u, V v)
+  {
+    while (true)
+    {
+      u = find(u);
+      v = find(v);
+      if (u == v)
+        return false;
+      if (linksUnder(v, u))
+        std::swap(u, v);
+      V expected = u;
+      if (parent_[u].compare_exchange_strong(expected, v, std::memory_order_acq_rel))
+        return true;
+    }
+  }
+};
+
+#endif
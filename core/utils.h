@@ -8,13 +8,13 @@
 #include <iostream>
 #include <limits.h>
 #include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
 
-#define intV int32_t
-#define uintV int32_t
-#define UINTV_MAX INT_MAX
-#define WeightType int32_t
-#define MAX_WEIGHT INT_MAX
-
+// Vertex ids and edge weights are template parameters of Graph (see
+// graph_types.h); these remain for counts such as the number of threads.
 #define intE int32_t
 #define uintE int32_t
 
@@ -25,6 +25,48 @@
 #define THREAD_LOGS 0
 // #define ADDITIONAL_TIMER_LOGS 0
 
+// When set, runOnThreads() pins worker t to the t-th CPU the process may run
+// on (modulo their count), so data first touched by worker t stays local to
+// worker t of later runOnThreads() passes (see memory_policy.h). ThreadPool
+// workers are not pinned.
+inline std::atomic<bool> &pinThreads() {
+  static std::atomic<bool> pin(false);
+  return pin;
+}
+
+inline void pinCurrentThread(uintE t) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+    return;
+  int target = t % CPU_COUNT(&allowed);
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+      return;
+    }
+  }
+}
+
+// Runs f(t) for t = 0 .. nThreads-1, each on its own std::thread, and joins
+template <class F>
+void runOnThreads(uintE nThreads, F &&f) {
+  std::vector<std::thread> threads;
+  threads.reserve(nThreads);
+  bool pin = pinThreads();
+  for (uintE t = 0; t < nThreads; ++t)
+    threads.emplace_back([&f, t, pin] {
+      if (pin)
+        pinCurrentThread(t);
+      f(t);
+    });
+  for (std::thread &th : threads)
+    th.join();
+}
+
 struct CustomBarrier {
   int num_of_threads_;
   int current_waiting_;
@@ -1,24 +1,29 @@
 #include "core/graph.h"
+#include "core/graph_builder.h"
+#include "core/graph_reorder.h"
+#include "core/kruskal.h"
+#include "core/loser_tree.h"
+#include "core/union_find.h"
 #include "core/utils.h"
-#include <climits>
 #include <mpi.h>
 #include <vector>
 #include <algorithm>
+#include <climits>
+#include <cstddef>
 #include <iostream>
 #include <numeric>
+#include <unordered_map>
 #include <fstream>
-#include <sstream>
-
-#define INF INT_MAX
 
 // Structure to represent an edge
+template <class V, class W>
 struct Edge {
-    int weight;
-    int vertex1;
-    int vertex2;
+    W weight;
+    V vertex1;
+    V vertex2;
 
-    Edge() : weight(INF), vertex1(-1), vertex2(-1) {}
-    Edge(int w, int v1, int v2) : weight(w), vertex1(v1), vertex2(v2) {}
+    Edge() : weight(maxWeight<W>()), vertex1(noVertex<V>()), vertex2(noVertex<V>()) {}
+    Edge(W w, V v1, V v2) : weight(w), vertex1(v1), vertex2(v2) {}
 
     // Comparison operator for sorting
     bool operator<(const Edge& e) const {
@@ -26,194 +31,831 @@ struct Edge {
     }
 };
 
-// Class for Union-Find data structure
-class UnionFind {
-public:
-    std::vector<int> parent;
-    std::vector<int> rank;
-
-    UnionFind(int size) : parent(size), rank(size, 0) {
-        std::iota(parent.begin(), parent.end(), 0); // Initialize parent array
-    }
-
-    // Find operation with path compression
-    int find(int u) {
-        if (parent[u] != u)
-            parent[u] = find(parent[u]);  // Path compression
-        return parent[u];
-    }
-
-    // Optimize rank with the union operation
-    bool unionSet(int u, int v) {
-        int rootU = find(u);
-        int rootV = find(v);
-        if (rootU != rootV) {
-            if (rank[rootU] > rank[rootV])
-                parent[rootV] = rootU;
-            else if (rank[rootU] < rank[rootV])
-                parent[rootU] = rootV;
-            else {
-                parent[rootV] = rootU;
-                rank[rootU]++;
-            }
-            return true;
-        }
-        return false;
+// Largest count passed to a single MPI call. Longer transfers are split into
+// rounds, so edge counts past INT_MAX (and byte counts past it, which the
+// old MPI_BYTE transfers overflowed at ~178M edges) never reach an int.
+// Build with a small -DMPI_COUNT_LIMIT to exercise the split paths.
+#ifndef MPI_COUNT_LIMIT
+#define MPI_COUNT_LIMIT INT_MAX
+#endif
+const uint64_t COUNT_LIMIT = MPI_COUNT_LIMIT;
+
+// MPI datatype describing T
+template <class T>
+struct MpiType;
+template <> struct MpiType<int16_t> { static MPI_Datatype get() { return MPI_INT16_T; } };
+template <> struct MpiType<int32_t> { static MPI_Datatype get() { return MPI_INT32_T; } };
+template <> struct MpiType<uint32_t> { static MPI_Datatype get() { return MPI_UINT32_T; } };
+template <> struct MpiType<uint64_t> { static MPI_Datatype get() { return MPI_UINT64_T; } };
+template <> struct MpiType<float> { static MPI_Datatype get() { return MPI_FLOAT; } };
+template <> struct MpiType<double> { static MPI_Datatype get() { return MPI_DOUBLE; } };
+
+// Commits a struct datatype from its (offset, type) fields, resized to size
+// bytes so arrays of the struct stride correctly. Padding between fields is
+// not part of the type, so it is never sent.
+inline MPI_Datatype structDatatype(const std::vector<std::pair<MPI_Aint, MPI_Datatype>>& fields, size_t size) {
+    std::vector<int> lengths(fields.size(), 1);
+    std::vector<MPI_Aint> offsets;
+    std::vector<MPI_Datatype> types;
+    for (const auto& f : fields) {
+        offsets.push_back(f.first);
+        types.push_back(f.second);
+    }
+    MPI_Datatype layout, type;
+    MPI_Type_create_struct((int)fields.size(), lengths.data(), offsets.data(), types.data(), &layout);
+    MPI_Type_create_resized(layout, 0, (MPI_Aint)size, &type);
+    MPI_Type_commit(&type);
+    MPI_Type_free(&layout);
+    return type;
+}
+
+// One committed datatype per Edge instantiation, e.g. 10 bytes of an
+// Edge<uint32_t, int16_t> whose layout is padded to 12
+template <class V, class W>
+struct MpiType<Edge<V, W>> {
+    static MPI_Datatype get() {
+        typedef Edge<V, W> EdgeT;
+        static MPI_Datatype type = structDatatype({{offsetof(EdgeT, weight), MpiType<W>::get()},
+                                                   {offsetof(EdgeT, vertex1), MpiType<V>::get()},
+                                                   {offsetof(EdgeT, vertex2), MpiType<V>::get()}},
+                                                  sizeof(EdgeT));
+        return type;
     }
 };
 
-// Function to compute Minimum Spanning Tree (MST)
-void computeMST(const std::vector<Edge>& edges, int V) {
-    long mst_weight = 0;
-    UnionFind uf(V);
-    std::vector<Edge> mst;
+// Exclusive prefix sums of counts
+inline std::vector<uint64_t> offsetsOf(const std::vector<uint64_t>& counts) {
+    std::vector<uint64_t> offsets(counts.size(), 0);
+    for (size_t i = 1; i < counts.size(); ++i)
+        offsets[i] = offsets[i - 1] + counts[i - 1];
+    return offsets;
+}
 
-    // Iterate over edges and apply Kruskal's algorithm
-    for (const auto& e : edges) {
-        if (uf.unionSet(e.vertex1, e.vertex2)) {
-            mst.push_back(e);
-            mst_weight+=e.weight;
-            if (mst.size() == V - 1) break; // MST found
-        }
+// Int counts and displacements of one vector collective call moving, for
+// every rank i, elements [begin, begin + chunk) of counts[i]
+inline void roundCounts(const std::vector<uint64_t>& counts, uint64_t begin, uint64_t chunk,
+                        std::vector<int>& c, std::vector<int>& d) {
+    c.assign(counts.size(), 0);
+    d.assign(counts.size(), 0);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        c[i] = (int)(counts[i] > begin ? std::min(chunk, counts[i] - begin) : 0);
+        if (i > 0)
+            d[i] = d[i - 1] + c[i - 1];
     }
+}
+
+// MPI_Scatterv of consecutive slices of send (counts[i] elements for rank
+// i, known on every rank) into recv. When all of it fits one call it is
+// one call; otherwise the root stages at most COUNT_LIMIT elements per
+// round so that no count or displacement overflows.
+template <class T>
+void scatterLarge(const T* send, const std::vector<uint64_t>& counts, T* recv, int root, int world_rank,
+                  int world_size) {
+    MPI_Datatype type = MpiType<T>::get();
+    std::vector<uint64_t> offsets = offsetsOf(counts);
+    std::vector<int> c, d;
+    if (offsets.back() + counts.back() <= COUNT_LIMIT) {
+        roundCounts(counts, 0, COUNT_LIMIT, c, d);
+        MPI_Scatterv(send, c.data(), d.data(), type, recv, c[world_rank], type, root, MPI_COMM_WORLD);
+        return;
+    }
+    uint64_t chunk = std::max<uint64_t>(1, COUNT_LIMIT / world_size);
+    uint64_t longest = *std::max_element(counts.begin(), counts.end());
+    std::vector<T> staging(world_rank == root ? chunk * world_size : 0);
+    for (uint64_t begin = 0; begin < longest; begin += chunk) {
+        roundCounts(counts, begin, chunk, c, d);
+        if (world_rank == root)
+            for (int i = 0; i < world_size; ++i) {
+                const T* from = send + offsets[i] + std::min(begin, counts[i]);
+                std::copy(from, from + c[i], staging.data() + d[i]);
+            }
+        MPI_Scatterv(staging.data(), c.data(), d.data(), type, recv + begin, c[world_rank], type, root,
+                     MPI_COMM_WORLD);
+    }
+}
+
+// MPI_Gatherv of every rank's local elements onto root, in rank order, split
+// into rounds like scatterLarge. counts is set to every rank's count.
+template <class T>
+std::vector<T> gatherLarge(const std::vector<T>& local, std::vector<uint64_t>& counts, int root, int world_rank,
+                           int world_size) {
+    MPI_Datatype type = MpiType<T>::get();
+    uint64_t mine = local.size();
+    counts.assign(world_size, 0);
+    MPI_Allgather(&mine, 1, MPI_UINT64_T, counts.data(), 1, MPI_UINT64_T, MPI_COMM_WORLD);
+    std::vector<uint64_t> offsets = offsetsOf(counts);
+    uint64_t total = offsets.back() + counts.back();
+    std::vector<T> gathered(world_rank == root ? total : 0);
+    std::vector<int> c, d;
+    if (total <= COUNT_LIMIT) {
+        roundCounts(counts, 0, COUNT_LIMIT, c, d);
+        MPI_Gatherv(local.data(), c[world_rank], type, gathered.data(), c.data(), d.data(), type, root,
+                    MPI_COMM_WORLD);
+        return gathered;
+    }
+    uint64_t chunk = std::max<uint64_t>(1, COUNT_LIMIT / world_size);
+    uint64_t longest = *std::max_element(counts.begin(), counts.end());
+    std::vector<T> staging(world_rank == root ? chunk * world_size : 0);
+    for (uint64_t begin = 0; begin < longest; begin += chunk) {
+        roundCounts(counts, begin, chunk, c, d);
+        MPI_Gatherv(local.data() + std::min(begin, mine), c[world_rank], type, staging.data(), c.data(), d.data(),
+                    type, root, MPI_COMM_WORLD);
+        if (world_rank == root)
+            for (int i = 0; i < world_size; ++i)
+                std::copy(staging.data() + d[i], staging.data() + d[i] + c[i],
+                          gathered.data() + offsets[i] + std::min(begin, counts[i]));
+    }
+    return gathered;
+}
 
+// Point-to-point send of a whole vector: its length, then the elements in
+// messages of at most COUNT_LIMIT
+template <class T>
+void sendLarge(const std::vector<T>& data, int dest, int tag) {
+    uint64_t n = data.size();
+    MPI_Send(&n, 1, MPI_UINT64_T, dest, tag, MPI_COMM_WORLD);
+    for (uint64_t begin = 0; begin < n; begin += COUNT_LIMIT)
+        MPI_Send(data.data() + begin, (int)std::min(COUNT_LIMIT, n - begin), MpiType<T>::get(), dest, tag,
+                 MPI_COMM_WORLD);
+}
+
+template <class T>
+std::vector<T> recvLarge(int source, int tag) {
+    uint64_t n = 0;
+    MPI_Recv(&n, 1, MPI_UINT64_T, source, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    std::vector<T> data(n);
+    for (uint64_t begin = 0; begin < n; begin += COUNT_LIMIT)
+        MPI_Recv(data.data() + begin, (int)std::min(COUNT_LIMIT, n - begin), MpiType<T>::get(), source, tag,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    return data;
+}
+
+// Writes the MST edges to result_mpi.out and prints their total weight
+template <class V, class W>
+void writeMST(const std::vector<Edge<V, W>>& mst, const VertexOrdering<V>& ids) {
+    WeightSum<W> mst_weight = 0;
     std::ofstream out("./outputs/result_mpi.out");
     for (const auto& e : mst) {
-        out << e.vertex1 << " - " << e.vertex2 << " with weight " << e.weight << std::endl;
+        mst_weight += e.weight;
+        out << ids.original(e.vertex1) << " - " << ids.original(e.vertex2) << " with weight " << e.weight << std::endl;
     }
     out.close();
 
     std::cout << "MST weight is : " << mst_weight << std::endl;
 }
 
-int main(int argc, char** argv) {
-    cxxopts::Options options(
-        "minimum_weight_spanning_tree",
-        "Calculate MST using serial, parallel and MPI execution");
-    options.add_options(
-        "",
-        {
-            {"inputFile", "Input graph file path",
-             cxxopts::value<std::string>()->default_value(
-                 "./testing_graphs/filtered_graph_1000")},
-        });
+// Kruskal over edges sorted by weight; the forest comes out in weight order
+template <class V, class W>
+std::vector<Edge<V, W>> localForest(const std::vector<Edge<V, W>>& sorted, V numVertices) {
+    DisjointSets<V> uf(numVertices);
+    std::vector<Edge<V, W>> forest;
+    for (const auto& e : sorted) {
+        if (uf.unite(e.vertex1, e.vertex2)) {
+            forest.push_back(e);
+            if (forest.size() + 1 >= numVertices) break;
+        }
+    }
+    return forest;
+}
 
-    auto cl_options = options.parse(argc, argv);
-    std::string input_file_path = cl_options["inputFile"].as<std::string>();
+// Gathers every sorted slice on the leader, merges them and runs Kruskal
+template <class V, class W>
+void gatherMST(const std::vector<Edge<V, W>>& local_edges, V v, const VertexOrdering<V>& ids,
+               int world_rank, int world_size) {
+    typedef Edge<V, W> EdgeT;
+    // Gather sorted edges from all processes
+    std::vector<uint64_t> counts;
+    std::vector<EdgeT> gathered_edges = gatherLarge(local_edges, counts, 0, world_rank, world_size);
+    std::vector<uint64_t> offsets = offsetsOf(counts);
 
-    // MPI initialization
-    MPI_Init(&argc, &argv);
-    int world_rank, world_size;
-    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    // The leader merges the sorted slices with a loser tree and feeds the
+    // edges straight into Kruskal, stopping once the tree spans all vertices
+    if (world_rank == 0) {
+        std::vector<std::pair<const EdgeT*, const EdgeT*>> runs;
+        for (int i = 0; i < world_size; ++i) {
+            const EdgeT* first = gathered_edges.data() + offsets[i];
+            runs.emplace_back(first, first + counts[i]);
+        }
+        LoserTree<EdgeT> merge(runs);
+
+        DisjointSets<V> uf(v);
+        std::vector<EdgeT> mst;
+        uint64_t tree_edges = v > 0 ? v - 1 : 0;
+        for (; !merge.empty() && mst.size() < tree_edges; merge.pop()) {
+            const EdgeT& e = merge.top();
+            if (uf.unite(e.vertex1, e.vertex2))
+                mst.push_back(e);
+        }
+        writeMST(mst, ids);
+    }
+}
 
-    std::vector<Edge> all_edges;
-    int v=0;  //vertex counter
+// Every rank reduces its sorted slice to its minimum spanning forest (at
+// most V-1 edges). The forests are then combined pairwise in a binomial
+// tree: in round k, rank r with r % 2^(k+1) == 2^k sends its forest to rank
+// r - 2^k, which merges the two (both are in weight order) and keeps the
+// forest of the union. No edge dropped on the way can be in the MST: it
+// closed a cycle of lighter edges in some subset of the graph. The leader
+// receives O(V) edges per round, O(V log P) in total.
+template <class V, class W>
+void treeMergeMST(const std::vector<Edge<V, W>>& local_edges, V v, const VertexOrdering<V>& ids,
+                  int world_rank, int world_size) {
+    typedef Edge<V, W> EdgeT;
+    std::vector<EdgeT> forest = localForest(local_edges, v);
+
+    for (int step = 1; step < world_size; step <<= 1) {
+        if (world_rank % (2 * step) == step) {
+            sendLarge(forest, world_rank - step, 0);
+            return;
+        }
+        if (world_rank + step < world_size) {
+            std::vector<EdgeT> received = recvLarge<EdgeT>(world_rank + step, 0);
 
-    
-    //The leader process is responsible for reading the graph
-    if (world_rank == 0) {
-        std::ifstream file(input_file_path);
-        if (!file.is_open()) {
-            std::cerr << "Error opening file." << std::endl;
-            MPI_Abort(MPI_COMM_WORLD, 1);
+            std::vector<EdgeT> merged(forest.size() + received.size());
+            std::merge(forest.begin(), forest.end(), received.begin(), received.end(), merged.begin());
+            forest = localForest(merged, v);
+        }
+    }
+
+    if (world_rank == 0)
+        writeMST(forest, ids);
+}
+
+// Vertex v (and component v, components are named by a vertex) belongs to
+// rank v / block, so every rank owns one contiguous block of ids and sorted
+// id lists are already grouped by owner.
+struct BlockPartition {
+    uint64_t n;
+    uint64_t block;
+
+    BlockPartition(uint64_t num_vertices, int parts)
+        : n(num_vertices), block(std::max<uint64_t>(1, (num_vertices + parts - 1) / parts)) {}
+
+    int owner(uint64_t x) const { return (int)(x / block); }
+    uint64_t first(int rank) const { return std::min(n, rank * block); }
+    uint64_t last(int rank) const { return std::min(n, (rank + 1) * block); }
+};
+
+// Sends outgoing[r] to rank r and returns what every rank sent here, in rank
+// order; received_counts[r] is set to the number of items from rank r. Split
+// into rounds of at most COUNT_LIMIT / P items per pair when some rank's
+// total would not fit one MPI_Alltoallv.
+template <class T>
+std::vector<T> allToAll(const std::vector<std::vector<T>>& outgoing, std::vector<uint64_t>& received_counts,
+                        int world_size) {
+    MPI_Datatype type = MpiType<T>::get();
+    std::vector<uint64_t> sendcounts(world_size);
+    for (int r = 0; r < world_size; ++r)
+        sendcounts[r] = outgoing[r].size();
+    received_counts.assign(world_size, 0);
+    MPI_Alltoall(sendcounts.data(), 1, MPI_UINT64_T, received_counts.data(), 1, MPI_UINT64_T, MPI_COMM_WORLD);
+    std::vector<uint64_t> roffsets = offsetsOf(received_counts);
+    uint64_t sent = std::accumulate(sendcounts.begin(), sendcounts.end(), uint64_t(0));
+    uint64_t local_largest = std::max(sent, roffsets.back() + received_counts.back()), largest = 0;
+    MPI_Allreduce(&local_largest, &largest, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+
+    std::vector<T> received(roffsets.back() + received_counts.back());
+    uint64_t chunk = largest <= COUNT_LIMIT ? COUNT_LIMIT : std::max<uint64_t>(1, COUNT_LIMIT / world_size);
+    std::vector<int> sc, sd, rc, rd;
+    std::vector<T> send, recv;
+    for (uint64_t begin = 0; begin < largest; begin += chunk) {
+        roundCounts(sendcounts, begin, chunk, sc, sd);
+        roundCounts(received_counts, begin, chunk, rc, rd);
+        send.clear();
+        for (int r = 0; r < world_size; ++r)
+            send.insert(send.end(), outgoing[r].begin() + std::min(begin, sendcounts[r]),
+                        outgoing[r].begin() + std::min(begin, sendcounts[r]) + sc[r]);
+        if (largest <= COUNT_LIMIT) {
+            MPI_Alltoallv(send.data(), sc.data(), sd.data(), type, received.data(), rc.data(), rd.data(), type,
+                          MPI_COMM_WORLD);
+            break;
         }
+        recv.resize(rd.back() + rc.back());
+        MPI_Alltoallv(send.data(), sc.data(), sd.data(), type, recv.data(), rc.data(), rd.data(), type,
+                      MPI_COMM_WORLD);
+        for (int r = 0; r < world_size; ++r)
+            std::copy(recv.begin() + rd[r], recv.begin() + rd[r] + rc[r], received.begin() + roffsets[r] + begin);
+    }
+    return received;
+}
+
+// Asks the owner of every id in keys (sorted, no repeats) for value(id) and
+// returns the answers in the order of keys. Collective: every rank must call
+// it, and answers come from the owners' state before anyone updates it.
+template <class V, class F>
+std::vector<V> remoteLookup(const std::vector<V>& keys, const BlockPartition& part, int world_size, F&& value) {
+    std::vector<std::vector<V>> requests(world_size);
+    for (V x : keys)
+        requests[part.owner(x)].push_back(x);
+    std::vector<uint64_t> counts;
+    std::vector<V> asked = allToAll(requests, counts, world_size);
+
+    std::vector<std::vector<V>> answers(world_size);
+    size_t i = 0;
+    for (int r = 0; r < world_size; ++r)
+        for (uint64_t k = 0; k < counts[r]; ++k)
+            answers[r].push_back(value(asked[i++]));
+    return allToAll(answers, counts, world_size);
+}
+
+// Sorted ids without repeats
+template <class V>
+void sortUnique(std::vector<V>& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+// Total order on edges: weight, then endpoints, so every rank picks the same
+// lightest edge among equal weights
+template <class V, class W>
+bool lighterEdge(const Edge<V, W>& e, const Edge<V, W>& f) {
+    if (e.weight != f.weight)
+        return e.weight < f.weight;
+    if (e.vertex1 != f.vertex1)
+        return e.vertex1 < f.vertex1;
+    return e.vertex2 < f.vertex2;
+}
+
+// Live edge of the distributed Boruvka, with the components of its
+// endpoints (a < b)
+template <class V, class W>
+struct BoruvkaArc {
+    Edge<V, W> edge;
+    V a;
+    V b;
+};
+
+// Candidate lightest edge of component comp, sent to the owner of comp
+template <class V, class W>
+struct BoruvkaOffer {
+    Edge<V, W> edge;
+    V comp;  // component the edge leaves
+    V other; // component across the edge
+};
+
+template <class V, class W>
+struct MpiType<BoruvkaOffer<V, W>> {
+    static MPI_Datatype get() {
+        typedef BoruvkaOffer<V, W> Offer;
+        static MPI_Datatype type = structDatatype({{offsetof(Offer, edge), MpiType<Edge<V, W>>::get()},
+                                                   {offsetof(Offer, comp), MpiType<V>::get()},
+                                                   {offsetof(Offer, other), MpiType<V>::get()}},
+                                                  sizeof(Offer));
+        return type;
+    }
+};
+
+// Keeps only the lightest arc between every pair of components; mirrored
+// and repeated input lines and parallel edges left by contraction can never
+// be chosen over it
+template <class V, class W>
+void keepLightestArcs(std::vector<BoruvkaArc<V, W>>& arcs) {
+    std::sort(arcs.begin(), arcs.end(), [](const BoruvkaArc<V, W>& x, const BoruvkaArc<V, W>& y) {
+        if (x.a != y.a)
+            return x.a < y.a;
+        if (x.b != y.b)
+            return x.b < y.b;
+        return lighterEdge(x.edge, y.edge);
+    });
+    arcs.erase(std::unique(arcs.begin(), arcs.end(), [](const BoruvkaArc<V, W>& x, const BoruvkaArc<V, W>& y) {
+                   return x.a == y.a && x.b == y.b;
+               }),
+               arcs.end());
+}
 
-        std::string line;
-        // Skip the header line
-        std::getline(file, line);
+// Distributed Boruvka over a block vertex partition. Every edge (endpoints
+// in increasing order) is first moved to the owner of its lower endpoint, so
+// no rank holds more than its vertices' share of the graph; the component
+// state (parent pointers, lightest edges) lives with the owner of the
+// component id. Every round:
+//
+//   1. min-edge selection: every live edge offers itself to the components
+//      of both endpoints; each rank keeps the lightest local offer per
+//      component and sends it to the component's owner, which keeps the
+//      lightest overall
+//   2. hooking: every component points at the component across its lightest
+//      edge and records that edge; when two components pick each other (the
+//      same edge, as the order is total) only the larger id hooks, so each
+//      forest edge is recorded once
+//   3. pointer jumping: parent[c] = parent[parent[c]] with lookups at the
+//      owners until no parent changes on any rank
+//   4. relabel/filter: edges ask the owners for their endpoints' new roots,
+//      edges inside a component are dropped and of several edges between
+//      the same two components each rank keeps only the lightest
+//
+// The rounds end once no component hooks; the forest is then gathered on
+// the leader. All messages are all-to-all exchanges of ids and edges.
+template <class V, class W>
+void boruvkaMST(const std::vector<Edge<V, W>>& local_edges, V v, const VertexOrdering<V>& ids,
+                int world_rank, int world_size) {
+    typedef Edge<V, W> EdgeT;
+    typedef BoruvkaArc<V, W> Arc;
+    typedef BoruvkaOffer<V, W> Offer;
+    BlockPartition part(v, world_size);
+    V first = (V)part.first(world_rank);
+    V owned = (V)(part.last(world_rank) - first);
+    std::vector<uint64_t> counts;
+
+    // Move every edge to the owner of its lower endpoint
+    std::vector<std::vector<EdgeT>> outgoing(world_size);
+    for (const EdgeT& e : local_edges)
+        if (e.vertex1 != e.vertex2)
+            outgoing[part.owner(std::min(e.vertex1, e.vertex2))].push_back(e);
+    std::vector<Arc> arcs;
+    for (const EdgeT& e : allToAll(outgoing, counts, world_size)) {
+        EdgeT ordered(e.weight, std::min(e.vertex1, e.vertex2), std::max(e.vertex1, e.vertex2));
+        arcs.push_back({ordered, ordered.vertex1, ordered.vertex2});
+    }
+    std::vector<std::vector<EdgeT>>().swap(outgoing);
+    keepLightestArcs(arcs);
+
+    std::vector<V> parent(owned);
+    std::iota(parent.begin(), parent.end(), first);
+    std::vector<EdgeT> best(owned);
+    std::vector<char> has_best(owned);
+    std::vector<EdgeT> forest;
+    auto parentOf = [&](V c) { return parent[c - first]; };
+
+    int round = 0;
+    for (;; ++round) {
+        // 1. Lightest local offer per component, then the lightest overall
+        std::unordered_map<V, Offer> local_best;
+        auto offer = [&](V comp, V other, const EdgeT& e) {
+            auto it = local_best.find(comp);
+            if (it == local_best.end())
+                local_best.emplace(comp, Offer{e, comp, other});
+            else if (lighterEdge(e, it->second.edge))
+                it->second = Offer{e, comp, other};
+        };
+        for (const Arc& arc : arcs) {
+            offer(arc.a, arc.b, arc.edge);
+            offer(arc.b, arc.a, arc.edge);
+        }
+        std::vector<std::vector<Offer>> offers(world_size);
+        for (const auto& kv : local_best)
+            offers[part.owner(kv.first)].push_back(kv.second);
+        std::unordered_map<V, Offer>().swap(local_best);
+
+        std::fill(has_best.begin(), has_best.end(), 0);
+        std::vector<V> target(owned);
+        for (const Offer& o : allToAll(offers, counts, world_size)) {
+            V i = o.comp - first;
+            if (!has_best[i] || lighterEdge(o.edge, best[i])) {
+                best[i] = o.edge;
+                target[i] = o.other;
+                has_best[i] = 1;
+            }
+        }
 
-        int max_vertex_id = -1; // Initialize max_vertex_id
-        while (std::getline(file, line)) {
-            int from, to, weight;
-            std::istringstream iss(line);
-            if (!(iss >> from >> to >> weight)) {
-                std::cerr << "Error reading line from file." << std::endl;
-                MPI_Abort(MPI_COMM_WORLD, 1);
+        // 2. Hook onto the component across the lightest edge; of two
+        // components choosing each other the smaller id stays a root
+        long long local_hooks = 0;
+        for (V i = 0; i < owned; ++i)
+            if (has_best[i])
+                parent[i] = target[i];
+        std::vector<V> keys;
+        for (V i = 0; i < owned; ++i)
+            if (has_best[i])
+                keys.push_back(target[i]);
+        sortUnique(keys);
+        std::vector<V> targets_parent = remoteLookup(keys, part, world_size, parentOf);
+        for (V i = 0; i < owned; ++i) {
+            if (!has_best[i])
+                continue;
+            V c = first + i;
+            V p = targets_parent[std::lower_bound(keys.begin(), keys.end(), target[i]) - keys.begin()];
+            if (p == c && c < target[i]) {
+                parent[i] = c;
+            } else {
+                forest.push_back(best[i]);
+                local_hooks++;
             }
-            max_vertex_id = std::max({max_vertex_id, from, to}); // Update max_vertex_id
-            all_edges.emplace_back(weight, from, to);
         }
-        v = max_vertex_id + 1; // Update vertex counter
+        long long hooks = 0;
+        MPI_Allreduce(&local_hooks, &hooks, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        if (hooks == 0)
+            break;
+
+        // 3. Pointer jumping until every component points at its root. Only
+        // this round's components are followed: edges never name a vertex
+        // that stopped being a root in an earlier round.
+        for (;;) {
+            keys.clear();
+            for (V i = 0; i < owned; ++i)
+                if (has_best[i] && parent[i] != first + i)
+                    keys.push_back(parent[i]);
+            sortUnique(keys);
+            std::vector<V> grandparent = remoteLookup(keys, part, world_size, parentOf);
+            int local_changed = 0, changed = 0;
+            for (V i = 0; i < owned; ++i) {
+                if (!has_best[i] || parent[i] == first + i)
+                    continue;
+                V g = grandparent[std::lower_bound(keys.begin(), keys.end(), parent[i]) - keys.begin()];
+                if (g != parent[i]) {
+                    parent[i] = g;
+                    local_changed = 1;
+                }
+            }
+            MPI_Allreduce(&local_changed, &changed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+            if (!changed)
+                break;
+        }
+
+        // 4. Relabel edges with their new roots and drop edges inside a
+        // component
+        keys.clear();
+        for (const Arc& arc : arcs) {
+            keys.push_back(arc.a);
+            keys.push_back(arc.b);
+        }
+        sortUnique(keys);
+        std::vector<V> root = remoteLookup(keys, part, world_size, parentOf);
+        auto rootOf = [&](V c) { return root[std::lower_bound(keys.begin(), keys.end(), c) - keys.begin()]; };
+        size_t live = 0;
+        for (const Arc& arc : arcs) {
+            V a = rootOf(arc.a), b = rootOf(arc.b);
+            if (a != b)
+                arcs[live++] = {arc.edge, std::min(a, b), std::max(a, b)};
+        }
+        arcs.resize(live);
+        keepLightestArcs(arcs);
     }
 
-    // Start timer
-    timer t1;
-    t1.start();
+    // Gather the forest on the leader in weight order
+    std::vector<EdgeT> mst = gatherLarge(forest, counts, 0, world_rank, world_size);
+
+    if (world_rank == 0) {
+        std::sort(mst.begin(), mst.end(), lighterEdge<V, W>);
+        std::cout << "Boruvka rounds : " << round << std::endl;
+        writeMST(mst, ids);
+    }
+}
+
+// Sorts every rank's edge slice (with n_threads threads of the rank's pool,
+// radix sort for integer weights) and combines the slices with the given strategy: "tree"
+// merges per-rank forests pairwise, "gather" ships every edge to the leader.
+// "boruvka" needs no sort and runs distributed Boruvka instead.
+template <class V, class W>
+void distributedMST(std::vector<Edge<V, W>>& local_edges, V v, const VertexOrdering<V>& ids,
+                    int world_rank, int world_size, ThreadPool& pool, uintE n_threads, const std::string& strategy) {
+    if (strategy == "boruvka") {
+        boruvkaMST(local_edges, v, ids, world_rank, world_size);
+        return;
+    }
+
+    // Sort local edges
+    bool radix = sortEdgesByWeight(local_edges.data(), local_edges.size(), pool, n_threads);
+    if (world_rank == 0)
+        std::cout << "Edge sort : " << (radix ? "radix" : "sample") << std::endl;
+
+    if (strategy == "gather")
+        gatherMST(local_edges, v, ids, world_rank, world_size);
+    else
+        treeMergeMST(local_edges, v, ids, world_rank, world_size);
+}
+
+// Distributes the leader's edge list in equal slices and runs
+// distributedMST. all_edges and ids are only meaningful on rank 0; t1 was
+// started before the leader began parsing.
+template <class V, class W>
+void scatterMST(std::vector<Edge<V, W>>& all_edges, V v, const VertexOrdering<V>& ids,
+                int world_rank, int world_size, ThreadPool& pool, uintE n_threads, const std::string& strategy,
+                timer& t1) {
+    typedef Edge<V, W> EdgeT;
 
     // The leader process splits data to worker processes
-    // Broadcast total number of edges to all processes
-    int total_edges = all_edges.size();
-    MPI_Bcast(&total_edges, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // Broadcast total number of edges and vertices to all processes
+    uint64_t total_edges = all_edges.size();
+    MPI_Bcast(&total_edges, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    uint64_t num_vertices = v;
+    MPI_Bcast(&num_vertices, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    v = (V)num_vertices;
 
     // Send edges data to all processes
-    std::vector<int> sendcounts(world_size, total_edges / world_size);
-    std::vector<int> displs(world_size, 0);
+    std::vector<uint64_t> sendcounts(world_size, total_edges / world_size);
 
     // Handle uneven distribution of edges
     for (int i = 0; i < world_size; ++i) {
-        if (i < total_edges % world_size) {
+        if ((uint64_t)i < total_edges % world_size) {
             sendcounts[i]++;
         }
     }
-    
-    // Calculate displacement for scatter operation
-    std::partial_sum(sendcounts.begin(), sendcounts.end() - 1, displs.begin() + 1);
-    std::transform(sendcounts.begin(), sendcounts.end(), sendcounts.begin(), [](int x) { return x * sizeof(Edge); });
-    std::transform(displs.begin(), displs.end(), displs.begin(), [](int x) { return x * sizeof(Edge); });
 
-    std::vector<Edge> local_edges(sendcounts[world_rank] / sizeof(Edge));
+    std::vector<EdgeT> local_edges(sendcounts[world_rank]);
 
     // Scatter edges to all processes
-    MPI_Scatterv(all_edges.data(), sendcounts.data(), displs.data(), MPI_BYTE,
-                 local_edges.data(), sendcounts[world_rank], MPI_BYTE, 0, MPI_COMM_WORLD);
+    scatterLarge(all_edges.data(), sendcounts, local_edges.data(), 0, world_rank, world_size);
+    std::vector<EdgeT>().swap(all_edges);
 
-    // Sort local edges
-    std::sort(local_edges.begin(), local_edges.end());
+    distributedMST(local_edges, v, ids, world_rank, world_size, pool, n_threads, strategy);
 
-    // Gather sorted edges from all processes
-    std::vector<Edge> gathered_edges(total_edges);
-    MPI_Gatherv(local_edges.data(), sendcounts[world_rank], MPI_BYTE,
-                gathered_edges.data(), sendcounts.data(), displs.data(), MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (world_rank == 0) {
+        // Stop timer and print total time taken
+        t1.stop();
+        std::cout << "Total time taken: " << t1.total() << std::endl;
+    }
+}
+
+// Moves every edge (endpoints in increasing order) to the rank picked by a
+// hash of its endpoints, so all copies of a vertex pair meet on one rank,
+// and keeps only the lightest copy there. Afterwards the ranks hold each
+// distinct edge exactly once, like the leader's CSR graph does.
+template <class V, class W>
+void dropRepeatedEdges(std::vector<Edge<V, W>>& local_edges, int world_size, ThreadPool& pool, uintE n_threads) {
+    typedef Edge<V, W> EdgeT;
+
+    if (world_size > 1) {
+        std::vector<std::vector<EdgeT>> outgoing(world_size);
+        for (const EdgeT& e : local_edges) {
+            uint64_t h = ((uint64_t)e.vertex1 * 0x9e3779b97f4a7c15ULL) ^ (uint64_t)e.vertex2;
+            outgoing[(h * 0x9e3779b97f4a7c15ULL >> 32) % world_size].push_back(e);
+        }
+        std::vector<EdgeT>().swap(local_edges);
+        std::vector<uint64_t> counts;
+        local_edges = allToAll(outgoing, counts, world_size);
+    }
+
+    auto byPair = [](const EdgeT& a, const EdgeT& b) {
+        if (a.vertex1 != b.vertex1)
+            return a.vertex1 < b.vertex1;
+        if (a.vertex2 != b.vertex2)
+            return a.vertex2 < b.vertex2;
+        return a.weight < b.weight;
+    };
+    sampleSort(local_edges.data(), local_edges.size(), byPair, pool, n_threads);
+    auto samePair = [](const EdgeT& a, const EdgeT& b) { return a.vertex1 == b.vertex1 && a.vertex2 == b.vertex2; };
+    local_edges.erase(std::unique(local_edges.begin(), local_edges.end(), samePair), local_edges.end());
+}
+
+// Every rank maps the text input and parses only its own line-aligned 1/P
+// byte range with n_threads threads, so nothing is parsed serially or
+// scattered. The ranks agree on the id/weight ranges (and with them the
+// graph types and the vertex count) with one MPI_Allreduce per field. Each
+// line becomes one edge with its endpoints in increasing order; self loops
+// are dropped, and mirrored and repeated lines are reduced to the lightest
+// copy by dropRepeatedEdges. t1 was started before the read.
+void parallelReadMST(const std::string& input_file_path, int world_rank, int world_size,
+                     ThreadPool& pool, uintE n_threads, const std::string& strategy, timer& t1) {
+    TextEdgeList slice(input_file_path, n_threads, world_rank, world_size);
+    EdgeListSummary local = slice.summarize();
+    EdgeListSummary summary;
+    int local_real = local.realWeights, real = 0;
+    MPI_Allreduce(&local.numEdges, &summary.numEdges, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&local.maxVertexId, &summary.maxVertexId, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(&local.minWeight, &summary.minWeight, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(&local.maxWeight, &summary.maxWeight, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(&local_real, &real, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+    summary.realWeights = real != 0;
+
+    dispatchGraphTypes(summary.types(), [&](auto vertexTag, auto weightTag) {
+        typedef typename decltype(vertexTag)::type V;
+        typedef typename decltype(weightTag)::type W;
+        typedef Edge<V, W> EdgeT;
+
+        std::vector<std::vector<EdgeT>> chunks(slice.numChunks());
+        slice.forEachChunkEdge([&](uintE c, uint64_t src, uint64_t dest, double weight) {
+            if (src != dest)
+                chunks[c].emplace_back((W)weight, (V)std::min(src, dest), (V)std::max(src, dest));
+        });
+        std::vector<EdgeT> local_edges;
+        local_edges.reserve(local.numEdges);
+        for (auto& chunk : chunks) {
+            local_edges.insert(local_edges.end(), chunk.begin(), chunk.end());
+            std::vector<EdgeT>().swap(chunk);
+        }
+        dropRepeatedEdges(local_edges, world_size, pool, n_threads);
+
+        if (world_rank == 0)
+            std::cout << "Parse time : " << t1.next() << std::endl;
 
+        distributedMST(local_edges, (V)(summary.maxVertexId + 1), VertexOrdering<V>(), world_rank, world_size,
+                       pool, n_threads, strategy);
+    });
 
-    // Root process merges n sorted vectors from work processes
     if (world_rank == 0) {
-        std::vector<Edge> fully_sorted_edges;
-        fully_sorted_edges.reserve(total_edges); // Reserve space to avoid reallocations
+        // Stop timer and print total time taken
+        t1.stop();
+        std::cout << "Total time taken: " << t1.total() << std::endl;
+    }
+}
 
-        std::vector<int> current_index(world_size, 0);
-        bool done = false;
+int main(int argc, char** argv) {
+    cxxopts::Options options(
+        "minimum_weight_spanning_tree",
+        "Calculate MST using serial, parallel and MPI execution");
+    options.add_options(
+        "",
+        {
+            {"nThreads", "Number of threads used to parse the input and to sort edges on every rank",
+             cxxopts::value<uintE>()->default_value(DEFAULT_NUMBER_OF_THREADS)},
+            {"inputFile", "Input graph file path",
+             cxxopts::value<std::string>()->default_value(
+                 "./testing_graphs/filtered_graph_1000")},
+            {"reorder", "Vertex relabelling for locality: none, bfs, rcm or degree",
+             cxxopts::value<std::string>()->default_value("none")},
+            {"strategy", "How ranks combine their edges: tree (merge per-rank forests pairwise), gather (all edges to the leader) or boruvka (distributed Boruvka over a vertex partition)",
+             cxxopts::value<std::string>()->default_value("tree")},
+            {"read", "How text inputs are read: parallel (every rank parses its own byte range) or leader (parsed on the leader and scattered)",
+             cxxopts::value<std::string>()->default_value("parallel")},
+        });
 
-        // Merge sorted edges
-        while (!done) {
-            Edge min_edge;
-            min_edge.weight = INF;
+    auto cl_options = options.parse(argc, argv);
+    uintE n_threads = cl_options["nThreads"].as<uintE>();
+    std::string input_file_path = cl_options["inputFile"].as<std::string>();
+    ReorderKind reorder = reorderKindFromName(cl_options["reorder"].as<std::string>());
+    std::string strategy = cl_options["strategy"].as<std::string>();
+    if (strategy != "tree" && strategy != "gather" && strategy != "boruvka") {
+        std::cerr << "Unknown strategy: " << strategy << std::endl;
+        return 1;
+    }
+    std::string read_mode = cl_options["read"].as<std::string>();
+    if (read_mode != "parallel" && read_mode != "leader") {
+        std::cerr << "Unknown read mode: " << read_mode << std::endl;
+        return 1;
+    }
 
-            int min_index = -1;
-            for (int i = 0; i < world_size; ++i) {
-                int global_index = displs[i] / sizeof(Edge) + current_index[i];
-                if (current_index[i] < sendcounts[i] / sizeof(Edge) && gathered_edges[global_index].weight < min_edge.weight) {
-                    min_edge = gathered_edges[global_index];
-                    min_index = i;
-                }
-            }
+    std::cout << std::fixed;
 
-            if (min_edge.weight == INF) {  // All vectors are exhausted
-                done = true;
-            } else {
-                fully_sorted_edges.push_back(min_edge);
-                current_index[min_index]++;
-            }
-        }
+    // MPI initialization
+    MPI_Init(&argc, &argv);
+    int world_rank, world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
 
-        // Compute MST using fully sorted edges
-        computeMST(fully_sorted_edges, v);
+    // Text inputs are read by all ranks at once unless the vertices are
+    // relabelled, which needs the whole graph in one place
+    int parallel_read = 0;
+    if (world_rank == 0)
+        parallel_read = read_mode == "parallel" && reorder == ReorderKind::None && !hasGraphFileMagic(input_file_path);
+    MPI_Bcast(&parallel_read, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
-        // Stop timer and print total time taken
-        double total_time = t1.stop();
-        std::cout << "Total time taken: " << total_time << std::endl;
+    // Sorts on every rank share one pool
+    ThreadPool pool(n_threads);
+
+    // Both read paths are timed from here, so their totals include parsing
+    timer t1;
+    t1.start();
+    if (parallel_read) {
+        try {
+            parallelReadMST(input_file_path, world_rank, world_size, pool, n_threads, strategy, t1);
+        } catch (const std::exception &e) {
+            std::cerr << "Error reading graph: " << e.what() << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Otherwise the leader process is responsible for reading the graph. It picks the
+    // vertex/weight types from the input and broadcasts them so every rank
+    // runs the same instantiation.
+    int graph_types[2] = {0, 0};
+    if (world_rank == 0) {
+        try {
+            loadGraph(input_file_path, n_threads, [&](auto &loaded) {
+                withReorderedGraph(loaded, reorder, input_file_path, n_threads, [&](const auto &g, const auto &ids) {
+                    typedef typename std::decay_t<decltype(g)>::VertexType V;
+                    typedef typename std::decay_t<decltype(g)>::WeightType W;
+
+                    // Flatten the CSR adjacency into an edge list. The graph stores each
+                    // undirected edge once per direction, so keeping src < dest emits
+                    // every distinct edge exactly once.
+                    std::vector<Edge<V, W>> all_edges;
+                    all_edges.reserve(g.numEdges() / 2);
+                    for (V u = 0; u < g.numVertices(); ++u) {
+                        for (const auto &nbr : g.getNeighbors(u)) {
+                            if (u < nbr.vertex) {
+                                all_edges.emplace_back(nbr.weight, u, nbr.vertex);
+                            }
+                        }
+                    }
+
+                    graph_types[0] = sizeof(V) == 8;
+                    graph_types[1] = (int)weightKindOf<W>();
+                    std::cout << "Parse time : " << t1.next() << std::endl;
+
+                    MPI_Bcast(graph_types, 2, MPI_INT, 0, MPI_COMM_WORLD);
+                    scatterMST(all_edges, g.numVertices(), ids, world_rank, world_size, pool, n_threads, strategy, t1);
+                });
+            });
+        } catch (const std::exception &e) {
+            std::cerr << "Error reading graph: " << e.what() << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    } else {
+        MPI_Bcast(graph_types, 2, MPI_INT, 0, MPI_COMM_WORLD);
+        GraphTypeInfo info;
+        info.wideVertices = graph_types[0] != 0;
+        info.weight = (WeightKind)graph_types[1];
+        dispatchGraphTypes(info, [&](auto vertexTag, auto weightTag) {
+            typedef typename decltype(vertexTag)::type V;
+            typedef typename decltype(weightTag)::type W;
+            std::vector<Edge<V, W>> no_edges;
+            scatterMST<V, W>(no_edges, 0, VertexOrdering<V>(), world_rank, world_size, pool, n_threads,
+                             strategy, t1);
+        });
     }
+
     MPI_Finalize();
     return 0;
-}
\ No newline at end of file
+}
@@ -1,4 +1,13 @@
+#include "core/boruvka.h"
+#include "core/compressed_graph.h"
+#include "core/edge_list.h"
+#include "core/filter_kruskal.h"
 #include "core/graph.h"
+#include "core/graph_builder.h"
+#include "core/graph_reorder.h"
+#include "core/kkt.h"
+#include "core/kruskal.h"
+#include "core/multi_seed_prim.h"
 #include "core/utils.h"
 #include "core/ThreadPool.h"
 #include <iomanip>
@@ -7,75 +16,142 @@
 #include <stdlib.h>
 #include <atomic>
 #include <thread>
-#include <mutex>
-#include <queue>
 #include <vector>
 #include <utility>
 #include <limits>
 
-// Mutex for managing access to the priority queue
-std::mutex pq_mutex;
-
-// Structure to represent an edge
-struct Edge {
-    int src, dest, weight;
-    Edge(int s, int d, int w) : src(s), dest(d), weight(w) {}
-    bool operator>(const Edge &other) const {
-        return weight > other.weight; // Comparison operator for min heap
+// Writes MST edges to result_parallel.out and prints the total weight
+template <class V, class W>
+void writeParallelResult(const std::vector<WeightedEdge<V, W>> &forest, const VertexOrdering<V> &ids) {
+    WeightSum<W> mstWeight = 0;
+    std::ofstream outFile("./outputs/result_parallel.out");
+    if (!outFile.is_open())
+        std::cerr << "Failed to open file for writing: " << "./outputs/result_parallel.out" << std::endl;
+    for (const WeightedEdge<V, W> &edge : forest) {
+        mstWeight += edge.weight;
+        if (outFile.is_open())
+            outFile << ids.original(edge.src) << " <-> " << ids.original(edge.dest) << " " << edge.weight << "\n";
     }
-};
-
-// Function to compute Minimum Spanning Tree (MST) in parallel
-void primMSTParallel(Graph &g, uintE n_threads) {
-    ThreadPool pool(n_threads); // ThreadPool object with specified number of threads
-    std::vector<bool> inMST(g.numVertices(), false); // Array to track if a vertex is in MST
-    std::vector<Edge> mstEdges; // List of edges in MST
-    std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> pq; // Priority queue for edges
-    inMST[0] = true; // Mark first vertex as visited
-    long mstWeight = 0; // Total weight of MST
+    std::cout << "Total weight of MST: " << mstWeight << std::endl;
+}
+
+// Multi-seed Prim (core/multi_seed_prim.h): every one of the n_threads
+// workers grows its own Prim trees with a private heap, then the trees are
+// contracted and the next round runs on the contracted graph. GraphT is
+// either Graph or CompressedGraph.
+template <class GraphT>
+void primMSTParallel(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, uintE n_threads) {
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+    ThreadPool pool(n_threads);
     timer t1;
     t1.start(); // Start timer
+    std::vector<WeightedEdge<V, W>> forest = multiSeedPrimMSF(g, pool, n_threads);
+    double mst_time = t1.next();
+    writeParallelResult(forest, ids);
+    t1.stop();
+    double total_time = t1.total();
 
-    // Initially, add all edges from the first vertex to the priority queue
-    const std::vector<uintV> &initialNeighbors = g.getNeighbors(0);
-    for (auto v : initialNeighbors) {
-        pq.emplace(0, v, g.getEdgeWeight(0, v)); // Add edges to priority queue
-    }
+    std::cout << "Prim time: " << mst_time << std::endl;
+    std::cout << "Total time taken: " << total_time << std::endl;
+}
 
-    while (!pq.empty()) {
-        std::lock_guard<std::mutex> lock(pq_mutex); // Lock access to priority queue
-        Edge minEdge = pq.top(); // Get minimum weight edge
-        pq.pop(); // Remove edge from priority queue
-
-        if (!inMST[minEdge.dest]) {
-            inMST[minEdge.dest] = true; // Mark vertex as visited
-            mstEdges.push_back(minEdge); // Add edge to MST
-            mstWeight += minEdge.weight; // Update total weight
-
-            // Add all valid edges from the newly added vertex
-            const std::vector<uintV> &newNeighbors = g.getNeighbors(minEdge.dest);
-            for (auto v : newNeighbors) {
-                if (!inMST[v]) {
-                    pq.emplace(minEdge.dest, v, g.getEdgeWeight(minEdge.dest, v)); // Add new edges to priority queue
-                }
-            }
-        }
-    }
-    
-    double total_time = t1.stop(); // Stop timer
+// Kruskal (core/kruskal.h): the edge list is sorted by n_threads threads,
+// with a radix sort when the weights are integers, and scanned once
+template <class GraphT>
+void kruskalMSTParallel(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, uintE n_threads) {
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+    ThreadPool pool(n_threads);
+    timer t1;
+    t1.start();
+    auto edges = collectEdges(g, n_threads);
+    double collect_time = t1.next();
+    bool radix = sortEdgesByWeight(edges.data(), edges.size(), pool, n_threads);
+    double sort_time = t1.next();
+    std::vector<WeightedEdge<V, W>> forest = kruskalForest(edges, g.numVertices());
+    double mst_time = t1.next();
+    writeParallelResult(forest, ids);
+    t1.stop();
+    double total_time = t1.total();
 
-    // Output the MST edges to a file
-    std::ofstream outFile("./outputs/result_parallel.out");
-    if (outFile.is_open()) {
-        for (const Edge& edge : mstEdges) {
-            outFile << edge.src << " <-> " << edge.dest << " " << edge.weight << std::endl;
-        }
-        outFile.close();
-    } else {
-        std::cerr << "Failed to open file for writing: " << "./outputs/result_parallel.out" << std::endl;
-    }
+    std::cout << "Edge sort : " << (radix ? "radix" : "sample") << std::endl;
+    std::cout << "Edge list time: " << collect_time << std::endl;
+    std::cout << "Sort time: " << sort_time << std::endl;
+    std::cout << "Kruskal time: " << mst_time << std::endl;
+    std::cout << "Total time taken: " << total_time << std::endl;
+}
 
-    std::cout << "Total weight of MST: " << mstWeight << std::endl;
+// Parallel Boruvka (core/boruvka.h) on the pool's n_threads workers
+template <class GraphT>
+void boruvkaMSTParallel(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, uintE n_threads) {
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+    ThreadPool pool(n_threads);
+    timer t1;
+    t1.start();
+    auto edges = collectEdges(g, n_threads);
+    double collect_time = t1.next();
+    std::vector<WeightedEdge<V, W>> forest;
+    for (uint64_t e : boruvkaMSF(edges, g.numVertices(), pool, n_threads))
+        forest.push_back(edges[e]);
+    double mst_time = t1.next();
+    writeParallelResult(forest, ids);
+    t1.stop();
+    double total_time = t1.total();
+
+    std::cout << "Edge list time: " << collect_time << std::endl;
+    std::cout << "Boruvka time: " << mst_time << std::endl;
+    std::cout << "Total time taken: " << total_time << std::endl;
+}
+
+// Karger-Klein-Tarjan sampling (core/kkt.h) with the heavy-edge filter and
+// compaction passes spread over the pool's n_threads workers
+template <class GraphT>
+void kktMSTParallel(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, uintE n_threads) {
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+    ThreadPool pool(n_threads);
+    timer t1;
+    t1.start();
+    auto edges = collectEdges(g, n_threads);
+    double collect_time = t1.next();
+    KargerKleinTarjan<V, W> engine(pool, n_threads);
+    std::vector<WeightedEdge<V, W>> forest = engine.run(edges, g.numVertices());
+    double mst_time = t1.next();
+    writeParallelResult(forest, ids);
+    t1.stop();
+    double total_time = t1.total();
+
+    std::cout << "F-heavy edges dropped over all levels: " << engine.heavyEdges()
+              << ", recursion depth: " << engine.recursionDepth() << std::endl;
+    std::cout << "Edge list time: " << collect_time << std::endl;
+    std::cout << "KKT time: " << mst_time << std::endl;
+    std::cout << "Total time taken: " << total_time << std::endl;
+}
+
+// Filter-Kruskal (core/filter_kruskal.h) with partition and filter passes
+// spread over the pool's n_threads workers
+template <class GraphT>
+void filterKruskalMSTParallel(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, uintE n_threads) {
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+    ThreadPool pool(n_threads);
+    timer t1;
+    t1.start();
+    auto edges = collectEdges(g, n_threads);
+    double collect_time = t1.next();
+    FilterKruskal<V, W> engine(g.numVertices(), pool, n_threads);
+    std::vector<WeightedEdge<V, W>> forest = engine.run(edges);
+    double mst_time = t1.next();
+    writeParallelResult(forest, ids);
+    t1.stop();
+    double total_time = t1.total();
+
+    std::cout << "Edges sorted: " << engine.sortedEdges() << " of " << edges.size()
+              << ", filtered: " << engine.filteredEdges() << std::endl;
+    std::cout << "Edge list time: " << collect_time << std::endl;
+    std::cout << "Filter-Kruskal time: " << mst_time << std::endl;
     std::cout << "Total time taken: " << total_time << std::endl;
 }
 
@@ -92,22 +168,59 @@ int main(int argc, char *argv[])
             {"inputFile", "Input graph file path",
              cxxopts::value<std::string>()->default_value(
                  "/scratch/input_graphs/roadNet-CA")},
+            {"reorder", "Vertex relabelling for locality: none, bfs, rcm or degree",
+             cxxopts::value<std::string>()->default_value("none")},
+            {"compressGraph", "Store adjacency delta/varint encoded with bit-packed weights",
+             cxxopts::value<bool>()->default_value("false")},
+            {"hugePages", "Huge pages for large arrays: none, thp or explicit",
+             cxxopts::value<std::string>()->default_value("none")},
+            {"numa", "NUMA placement for large arrays: default, firsttouch or interleave",
+             cxxopts::value<std::string>()->default_value("default")},
+            {"algorithm", "MST algorithm: prim, boruvka, kruskal, filter-kruskal or kkt",
+             cxxopts::value<std::string>()->default_value("prim")},
         });
 
     auto cl_options = options.parse(argc, argv);
     uintE n_threads = cl_options["nThreads"].as<uintE>();
     std::string input_file_path = cl_options["inputFile"].as<std::string>();
+    ReorderKind reorder = reorderKindFromName(cl_options["reorder"].as<std::string>());
+    bool compress_graph = cl_options["compressGraph"].as<bool>();
+    std::string huge_pages = cl_options["hugePages"].as<std::string>();
+    std::string numa = cl_options["numa"].as<std::string>();
+    std::string algorithm = cl_options["algorithm"].as<std::string>();
+    if (algorithm != "prim" && algorithm != "boruvka" && algorithm != "kruskal" && algorithm != "filter-kruskal" && algorithm != "kkt") {
+        std::cerr << "Unknown algorithm: " << algorithm << std::endl;
+        return 1;
+    }
 
     std::cout << std::fixed;
     std::cout << "Number of Threads : " << n_threads << std::endl;
+    std::cout << "Algorithm : " << algorithm << std::endl;
+    configureMemoryPolicy(huge_pages, numa, n_threads);
 
-    Graph g;
     std::cout << "Reading graph\n";
-    g.readGraphFromBinary<int>(input_file_path); // Read graph from binary file
-    std::cout << "Created graph\n";
+    // Read graph from a binary or text file into the narrowest fitting types
+    loadGraph(input_file_path, n_threads, [&](auto &loaded) {
+        std::cout << "Created graph\n";
+        printGraphTypes(loaded);
 
-    // Compute MST in parallel
-    primMSTParallel(g, n_threads);
+        withReorderedGraph(loaded, reorder, input_file_path, n_threads, [&](auto &relabelled, const auto &ids) {
+            withGraphBackend(relabelled, compress_graph, [&](const auto &g) {
+                // Compute MST in parallel
+                if (algorithm == "boruvka")
+                    boruvkaMSTParallel(g, ids, n_threads);
+                else if (algorithm == "kruskal")
+                    kruskalMSTParallel(g, ids, n_threads);
+                else if (algorithm == "filter-kruskal")
+                    filterKruskalMSTParallel(g, ids, n_threads);
+                else if (algorithm == "kkt")
+                    kktMSTParallel(g, ids, n_threads);
+                else
+                    primMSTParallel(g, ids, n_threads);
+                printMemoryPolicyUsage();
+            });
+        });
+    });
 
     return 0;
 }
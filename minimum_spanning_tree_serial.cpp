@@ -1,4 +1,11 @@
+#include "core/compressed_graph.h"
+#include "core/edge_list.h"
 #include "core/graph.h"
+#include "core/graph_builder.h"
+#include "core/graph_reorder.h"
+#include "core/kruskal.h"
+#include "core/indexed_heap.h"
+#include "core/bucket_queue.h"
 #include "core/utils.h"
 #include <iomanip>
 #include <iostream>
@@ -8,62 +15,195 @@
 #include <fstream>
 #include <utility>
 #include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 
-// Function to compute Minimum Spanning Tree (MST) serially
-void primMSTSerial(Graph &g)
+// Priority queue used by serial Prim
+enum class PrimQueue { Auto, Lazy, Indexed, Bucket };
+
+PrimQueue primQueueFromName(const std::string &name)
 {
-    timer t1;
-    t1.start();
-    uintV numVertices = g.numVertices_; // Number of vertices in the graph
-    std::vector<bool> inMST(numVertices, false); // Track if a vertex is in MST
-    std::vector<WeightType> key(numVertices, MAX_WEIGHT); // Key values used to pick minimum weight edge
-    std::vector<uintV> parent(numVertices, -1); // Parent array to store the MST
+    if (name == "auto") return PrimQueue::Auto;
+    if (name == "lazy") return PrimQueue::Lazy;
+    if (name == "indexed") return PrimQueue::Indexed;
+    if (name == "bucket") return PrimQueue::Bucket;
+    throw std::invalid_argument("Unknown queue: " + name);
+}
 
-    // Initialize total weight of MST
-    long totalWeight = 0;
+const char *primQueueName(PrimQueue queue)
+{
+    switch (queue)
+    {
+    case PrimQueue::Lazy: return "lazy";
+    case PrimQueue::Indexed: return "indexed";
+    case PrimQueue::Bucket: return "bucket";
+    default: return "auto";
+    }
+}
 
+// Lazy Prim: every key improvement pushes a fresh (key, vertex) pair and stale
+// pairs are skipped when popped, so the heap can hold O(E) entries. Like the
+// other variants it restarts from every vertex left unvisited, so the result
+// is a spanning forest of all components.
+template <class GraphT, class V, class W>
+void primLazy(const GraphT &g, PolicyVector<bool> &inMST, PolicyVector<W> &key, PolicyVector<V> &parent)
+{
     // Priority queue to store edges ordered by weight
-    std::priority_queue<std::pair<WeightType, uintV>,
-                        std::vector<std::pair<WeightType, uintV>>,
-                        std::greater<std::pair<WeightType, uintV>>>
+    std::priority_queue<std::pair<W, V>,
+                        std::vector<std::pair<W, V>>,
+                        std::greater<std::pair<W, V>>>
         minHeap;
 
-    // Initialize starting vertex
-    key[0] = 0;
-    minHeap.push({0, 0});
-
-    // Main loop to construct MST
-    while (!minHeap.empty())
+    for (V s = 0; s < g.numVertices(); ++s)
     {
-        uintV u = minHeap.top().second; // Get vertex with smallest key
-        minHeap.pop(); // Remove vertex from priority queue
-
-        if (inMST[u])
-            continue; // Skip if vertex is already in MST
+        if (inMST[s])
+            continue;
 
-        inMST[u] = true; // Mark vertex as visited
+        // Initialize starting vertex
+        key[s] = 0;
+        minHeap.push({0, s});
 
-        // Total weight update
-        if (u != 0) // Skip the first vertex as it does not contribute to the MST weight
+        // Main loop to construct MST
+        while (!minHeap.empty())
         {
-            totalWeight += key[u];
+            V u = minHeap.top().second; // Get vertex with smallest key
+            minHeap.pop(); // Remove vertex from priority queue
+
+            if (inMST[u])
+                continue; // Skip if vertex is already in MST
+
+            inMST[u] = true; // Mark vertex as visited
+
+            // Explore neighbors of u
+            g.forEachNeighbor(u, [&](V v, W weight) // Weight of edge (u, v)
+            {
+                // Update key value and parent if weight is smaller
+                if (!inMST[v] && weight < key[v])
+                {
+                    key[v] = weight;
+                    parent[v] = u;
+                    minHeap.push({key[v], v}); // Update minHeap with new key value for v
+                }
+            });
         }
+    }
+}
 
-        // Explore neighbors of u
-        const auto &neighbors = g.getNeighbors(u); // Get weight of edge (u, v)
-        for (const auto &v : neighbors)
+// Indexed Prim: each frontier vertex sits in the heap once and key
+// improvements are decrease-key operations, so the heap stays within V entries
+template <class GraphT, class V, class W>
+void primIndexed(const GraphT &g, PolicyVector<bool> &inMST, PolicyVector<W> &key, PolicyVector<V> &parent)
+{
+    IndexedDaryHeap<W, V> minHeap(g.numVertices());
+    for (V s = 0; s < g.numVertices(); ++s)
+    {
+        if (inMST[s])
+            continue;
+        key[s] = 0;
+        minHeap.push(s, 0);
+
+        while (!minHeap.empty())
         {
-            WeightType weight = g.getEdgeWeight(u, v);
+            V u = minHeap.pop().second;
+            inMST[u] = true;
+
+            g.forEachNeighbor(u, [&](V v, W weight)
+            {
+                if (!inMST[v] && weight < key[v])
+                {
+                    key[v] = weight;
+                    parent[v] = u;
+                    minHeap.pushOrDecrease(v, weight);
+                }
+            });
+        }
+    }
+}
 
-            // Update key value and parent if weight is smaller
+// Bucket-queue Prim for small integer weight ranges: vertex v waits in bucket
+// key[v] - minWeight, so insert and decrease-key are O(1) list operations
+template <class GraphT, class V, class W>
+void primBucket(const GraphT &g, PolicyVector<bool> &inMST, PolicyVector<W> &key, PolicyVector<V> &parent,
+                W minWeight, uint32_t numBuckets)
+{
+    BucketQueue<V> queue(g.numVertices(), numBuckets);
+    auto relax = [&](V u) {
+        g.forEachNeighbor(u, [&](V v, W weight)
+        {
             if (!inMST[v] && weight < key[v])
             {
                 key[v] = weight;
                 parent[v] = u;
-                minHeap.push({key[v], v}); // Update minHeap with new key value for v
+                queue.pushOrDecrease(v, uint32_t(int64_t(weight) - int64_t(minWeight)));
             }
+        });
+    };
+
+    for (V s = 0; s < g.numVertices(); ++s)
+    {
+        if (inMST[s])
+            continue;
+        key[s] = 0;
+        inMST[s] = true;
+        relax(s);
+        while (!queue.empty())
+        {
+            V u = queue.pop().second;
+            inMST[u] = true;
+            relax(u);
         }
     }
+}
+
+// Resolves --queue auto: the bucket queue when weights are integers spanning
+// at most BUCKET_QUEUE_MAX_KEYS values, otherwise the indexed heap
+template <class W>
+PrimQueue choosePrimQueue(PrimQueue requested, std::pair<W, W> range)
+{
+    bool fits = !std::is_floating_point<W>::value &&
+                int64_t(range.second) - int64_t(range.first) < int64_t(BUCKET_QUEUE_MAX_KEYS);
+    if (requested == PrimQueue::Auto)
+        return fits ? PrimQueue::Bucket : PrimQueue::Indexed;
+    if (requested == PrimQueue::Bucket && !fits)
+    {
+        std::cerr << "Weight range too wide for the bucket queue; using the indexed heap" << std::endl;
+        return PrimQueue::Indexed;
+    }
+    return requested;
+}
+
+// Function to compute Minimum Spanning Tree (MST) serially. GraphT is either
+// Graph or CompressedGraph; only numVertices() and forEachNeighbor() are used.
+template <class GraphT>
+void primMSTSerial(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, PrimQueue queue)
+{
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+
+    timer t1;
+    t1.start();
+    V numVertices = g.numVertices(); // Number of vertices in the graph
+    PolicyVector<bool> inMST(numVertices, false); // Track if a vertex is in MST
+    PolicyVector<W> key(numVertices, maxWeight<W>()); // Key values used to pick minimum weight edge
+    PolicyVector<V> parent(numVertices, noVertex<V>()); // Parent array to store the MST
+
+    auto range = graphWeightRange(g);
+    queue = choosePrimQueue(queue, range);
+    std::cout << "Prim queue : " << primQueueName(queue) << std::endl;
+    if (queue == PrimQueue::Lazy)
+        primLazy(g, inMST, key, parent);
+    else if (queue == PrimQueue::Bucket)
+        primBucket(g, inMST, key, parent, range.first,
+                   uint32_t(int64_t(range.second) - int64_t(range.first) + 1));
+    else
+        primIndexed(g, inMST, key, parent);
+
+    // Total weight of MST: the final key of every vertex joined through a parent
+    WeightSum<W> totalWeight = 0;
+    for (V v = 0; v < numVertices; ++v)
+        if (parent[v] != noVertex<V>())
+            totalWeight += key[v];
 
     // Write MST edges to output file
     std::ofstream outFile("./outputs/result_serial.out");
@@ -75,9 +215,9 @@ void primMSTSerial(Graph &g)
 
     for (size_t i = 1; i < numVertices; ++i)
     {
-        if (parent[i] != -1)
+        if (parent[i] != noVertex<V>())
         {
-            outFile << parent[i] << " <-> " << i << " " << key[i] << std::endl;
+            outFile << ids.original(parent[i]) << " <-> " << ids.original(i) << " " << key[i] << std::endl;
         }
     }
     
@@ -88,6 +228,46 @@ void primMSTSerial(Graph &g)
     std::cout << "Total time taken: " << total_time << std::endl;
 }
 
+// Kruskal (core/kruskal.h) on the edge list of g. The sort uses n_threads
+// threads, with a radix sort when the weights are integers.
+template <class GraphT>
+void kruskalMSTSerial(const GraphT &g, const VertexOrdering<typename GraphT::VertexType> &ids, uintE n_threads)
+{
+    typedef typename GraphT::VertexType V;
+    typedef typename GraphT::WeightType W;
+
+    ThreadPool pool(n_threads);
+    timer t1;
+    t1.start();
+    auto edges = collectEdges(g, n_threads);
+    double collect_time = t1.next();
+    bool radix = sortEdgesByWeight(edges.data(), edges.size(), pool, n_threads);
+    double sort_time = t1.next();
+    std::vector<WeightedEdge<V, W>> forest = kruskalForest(edges, g.numVertices());
+
+    WeightSum<W> totalWeight = 0;
+    std::ofstream outFile("./outputs/result_serial.out");
+    if (!outFile)
+    {
+        std::cerr << "Error opening output file." << std::endl;
+        return;
+    }
+    for (const WeightedEdge<V, W> &e : forest)
+    {
+        totalWeight += e.weight;
+        outFile << ids.original(e.src) << " <-> " << ids.original(e.dest) << " " << e.weight << "\n";
+    }
+
+    t1.stop();
+    double total_time = t1.total();
+
+    std::cout << "Edge sort : " << (radix ? "radix" : "sample") << std::endl;
+    std::cout << "Edge list time: " << collect_time << std::endl;
+    std::cout << "Sort time: " << sort_time << std::endl;
+    std::cout << "Total weight of MST: " << totalWeight << std::endl;
+    std::cout << "Total time taken: " << total_time << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
     cxxopts::Options options(
@@ -101,23 +281,58 @@ int main(int argc, char *argv[])
             {"inputFile", "Input graph file path",
              cxxopts::value<std::string>()->default_value(
                  "/scratch/testing_graphs/weighted_graph")},
+            {"reorder", "Vertex relabelling for locality: none, bfs, rcm or degree",
+             cxxopts::value<std::string>()->default_value("none")},
+            {"compressGraph", "Store adjacency delta/varint encoded with bit-packed weights",
+             cxxopts::value<bool>()->default_value("false")},
+            {"hugePages", "Huge pages for large arrays: none, thp or explicit",
+             cxxopts::value<std::string>()->default_value("none")},
+            {"numa", "NUMA placement for large arrays: default, firsttouch or interleave",
+             cxxopts::value<std::string>()->default_value("default")},
+            {"algorithm", "MST algorithm: prim or kruskal",
+             cxxopts::value<std::string>()->default_value("prim")},
+            {"queue", "Prim priority queue: auto, lazy, indexed (4-ary, decrease-key) or bucket (small integer weights)",
+             cxxopts::value<std::string>()->default_value("auto")},
         });
 
     auto cl_options = options.parse(argc, argv);
     uintE n_threads = cl_options["nThreads"].as<uintE>();
     std::string input_file_path = cl_options["inputFile"].as<std::string>();
+    ReorderKind reorder = reorderKindFromName(cl_options["reorder"].as<std::string>());
+    bool compress_graph = cl_options["compressGraph"].as<bool>();
+    std::string huge_pages = cl_options["hugePages"].as<std::string>();
+    std::string numa = cl_options["numa"].as<std::string>();
+    std::string algorithm = cl_options["algorithm"].as<std::string>();
+    PrimQueue queue = primQueueFromName(cl_options["queue"].as<std::string>());
+    if (algorithm != "prim" && algorithm != "kruskal")
+    {
+        std::cerr << "Unknown algorithm: " << algorithm << std::endl;
+        return 1;
+    }
 
     std::cout << std::fixed;
     std::cout << "Number of Threads : " << n_threads << std::endl;
+    std::cout << "Algorithm : " << algorithm << std::endl;
+    configureMemoryPolicy(huge_pages, numa, n_threads);
     std::cout << "Input File Path: " << input_file_path << std::endl;
 
-    Graph g;
     std::cout << "Reading graph\n";
-    g.readGraphFromBinary<int>(input_file_path); // Read graph from binary file
-    std::cout << "Created graph\n";
+    // Read graph from a binary or text file into the narrowest fitting types
+    loadGraph(input_file_path, n_threads, [&](auto &loaded) {
+        std::cout << "Created graph\n";
+        printGraphTypes(loaded);
 
-    // Compute MST serially
-    primMSTSerial(g);
+        withReorderedGraph(loaded, reorder, input_file_path, n_threads, [&](auto &relabelled, const auto &ids) {
+            withGraphBackend(relabelled, compress_graph, [&](const auto &g) {
+                // Compute MST serially
+                if (algorithm == "kruskal")
+                    kruskalMSTSerial(g, ids, n_threads);
+                else
+                    primMSTSerial(g, ids, queue);
+                printMemoryPolicyUsage();
+            });
+        });
+    });
 
     return 0;
 }